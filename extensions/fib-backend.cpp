@@ -0,0 +1,75 @@
+#include "fib-backend.hpp"
+
+#include <ns3/ndnSIM/helper/ndn-fib-helper.hpp>
+#include <ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp>
+#include <ns3/ndnSIM/NFD/daemon/table/fib.hpp>
+#include <ns3/simulator.h>
+#include <ns3/node-list.h>
+
+namespace ndn {
+namespace ndvr {
+
+void FibBackend::ResolveNode() {
+  using namespace ns3;
+
+  if (m_node)
+    return;
+  m_node = NodeList::GetNode(Simulator::GetContext());
+  m_l3 = m_node->GetObject<ns3::ndn::L3Protocol>();
+}
+
+bool FibHelperBackend::AddRoute(const Name& prefix, uint64_t faceId, uint32_t cost) {
+  ResolveNode();
+  auto face = m_l3->getFaceById(faceId);
+  if (face == nullptr)
+    return false;
+  ns3::ndn::FibHelper::AddRoute(m_node, prefix, face, cost);
+  return true;
+}
+
+bool FibHelperBackend::RemoveRoute(const Name& prefix, uint64_t faceId) {
+  ResolveNode();
+  auto face = m_l3->getFaceById(faceId);
+  if (face == nullptr)
+    return false;
+  ns3::ndn::FibHelper::RemoveRoute(m_node, prefix, face);
+  return true;
+}
+
+bool DirectFibBackend::AddRoute(const Name& prefix, uint64_t faceId, uint32_t cost) {
+  ResolveNode();
+  auto fw = m_l3->getForwarder();
+  ::nfd::Face* face = fw->getFaceTable().get(faceId);
+  if (face == nullptr)
+    return false;
+  ::nfd::Fib& fib = fw->getFib();
+  ::nfd::fib::Entry* entry = fib.insert(prefix).first;
+  fib.addOrUpdateNextHop(*entry, *face, cost);
+  return true;
+}
+
+bool DirectFibBackend::RemoveRoute(const Name& prefix, uint64_t faceId) {
+  ResolveNode();
+  auto fw = m_l3->getForwarder();
+  ::nfd::Face* face = fw->getFaceTable().get(faceId);
+  if (face == nullptr)
+    return false;
+  ::nfd::Fib& fib = fw->getFib();
+  ::nfd::fib::Entry* entry = fib.findExactMatch(prefix);
+  if (entry == nullptr)
+    return true;
+  /* the entry is erased by the Fib when its last next hop is removed */
+  fib.removeNextHop(*entry, *face);
+  return true;
+}
+
+std::unique_ptr<FibBackend> MakeFibBackend(const std::string& type) {
+  if (type == "management")
+    return std::unique_ptr<FibBackend>(new FibHelperBackend());
+  if (type == "direct")
+    return std::unique_ptr<FibBackend>(new DirectFibBackend());
+  return nullptr;
+}
+
+} // namespace ndvr
+} // namespace ndn
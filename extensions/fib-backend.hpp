@@ -0,0 +1,58 @@
+#ifndef _FIBBACKEND_H_
+#define _FIBBACKEND_H_
+
+#include <memory>
+#include <string>
+
+#include <ns3/ptr.h>
+#include <ns3/node.h>
+#include <ns3/ndnSIM/model/ndn-l3-protocol.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/**
+ * @brief how the routing table programs the node's FIB
+ *
+ *   AddRoute() and RemoveRoute() return false if the face does not
+ *   exist (anymore), in which case nothing was done.
+ */
+class FibBackend {
+public:
+  virtual ~FibBackend()
+  {
+  }
+
+  virtual bool AddRoute(const Name& prefix, uint64_t faceId, uint32_t cost) = 0;
+  virtual bool RemoveRoute(const Name& prefix, uint64_t faceId) = 0;
+
+protected:
+  /* resolved on first use, when running on the node context */
+  void ResolveNode();
+
+protected:
+  ns3::Ptr<ns3::Node> m_node;
+  ns3::Ptr<ns3::ndn::L3Protocol> m_l3;
+};
+
+/* NFD management commands (FibHelper), ie, signed ControlCommands */
+class FibHelperBackend : public FibBackend {
+public:
+  bool AddRoute(const Name& prefix, uint64_t faceId, uint32_t cost) override;
+  bool RemoveRoute(const Name& prefix, uint64_t faceId) override;
+};
+
+/* the forwarder's nfd::Fib, updated in place */
+class DirectFibBackend : public FibBackend {
+public:
+  bool AddRoute(const Name& prefix, uint64_t faceId, uint32_t cost) override;
+  bool RemoveRoute(const Name& prefix, uint64_t faceId) override;
+};
+
+/* type is "management" or "direct"; returns nullptr for unknown types */
+std::unique_ptr<FibBackend> MakeFibBackend(const std::string& type);
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _FIBBACKEND_H_
@@ -0,0 +1,52 @@
+#include "fib-queue.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+void FibQueue::Add(PrefixId n, uint64_t faceId, uint32_t cost) {
+  m_pending[RouteKey(n, faceId)] = {true, cost};
+}
+
+void FibQueue::Remove(PrefixId n, uint64_t faceId) {
+  m_pending[RouteKey(n, faceId)] = {false, 0};
+}
+
+void FibQueue::RemoveFace(uint64_t faceId) {
+  /* everything installed through the face goes, so that m_installed keeps
+   * matching the FIB; pending adds through it are cancelled */
+  for (const auto& installed : m_installed) {
+    if (installed.first.second == faceId)
+      m_pending[installed.first] = {false, 0};
+  }
+  for (auto& op : m_pending) {
+    if (op.first.second == faceId)
+      op.second = {false, 0};
+  }
+}
+
+void FibQueue::Flush() {
+  if (m_pending.empty())
+    return;
+
+  std::map<RouteKey, Operation> ops;
+  ops.swap(m_pending);
+  for (auto& op : ops) {
+    const Name& prefix = m_prefixes.GetName(op.first.first);
+    uint64_t faceId = op.first.second;
+    auto installed = m_installed.find(op.first);
+    if (op.second.add) {
+      if (installed != m_installed.end() && installed->second == op.second.cost)
+        continue;
+      if (m_backend->AddRoute(prefix, faceId, op.second.cost))
+        m_installed[op.first] = op.second.cost;
+    } else {
+      if (installed == m_installed.end())
+        continue;
+      m_installed.erase(installed);
+      m_backend->RemoveRoute(prefix, faceId);
+    }
+  }
+}
+
+} // namespace ndvr
+} // namespace ndn
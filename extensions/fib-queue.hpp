@@ -0,0 +1,70 @@
+#ifndef _FIBQUEUE_H_
+#define _FIBQUEUE_H_
+
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "fib-backend.hpp"
+#include "prefix-table.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+/**
+ * @brief FIB programming queue
+ *
+ *   Collects the FIB add/remove operations requested by the routing table
+ *   and applies them on Flush(). Operations are coalesced per (prefix,
+ *   face): only the last one is kept, and it is only applied if it
+ *   changes what was previously installed. Thus, an add followed by a
+ *   remove of a route that was not installed yet is a no-op, as is an
+ *   add that does not change the cost of an installed route.
+ *
+ *   Operations are applied through a FibBackend (NFD management
+ *   commands by default). A management command is a full command
+ *   round-trip, so the routing table flushes the queue once per batch
+ *   (see RoutingTable::Batch).
+ */
+class FibQueue {
+public:
+  explicit FibQueue(const PrefixTable& prefixes)
+    : m_prefixes(prefixes)
+    , m_backend(new FibHelperBackend())
+  {
+  }
+
+  /* must be set before any route is installed */
+  void SetBackend(std::unique_ptr<FibBackend> backend) {
+    m_backend = std::move(backend);
+  }
+
+  void Add(PrefixId n, uint64_t faceId, uint32_t cost);
+  void Remove(PrefixId n, uint64_t faceId);
+  void RemoveFace(uint64_t faceId);
+  void Flush();
+
+  size_t size() const {
+    return m_pending.size();
+  }
+
+private:
+  typedef std::pair<PrefixId, uint64_t> RouteKey;
+
+  struct Operation {
+    bool add;
+    uint32_t cost;
+  };
+
+private:
+  const PrefixTable& m_prefixes;
+  std::map<RouteKey, Operation> m_pending;
+  /* routes currently installed through this queue and their cost */
+  std::map<RouteKey, uint32_t> m_installed;
+  std::unique_ptr<FibBackend> m_backend;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _FIBQUEUE_H_
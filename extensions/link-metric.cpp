@@ -0,0 +1,48 @@
+#include "link-metric.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ndn {
+namespace ndvr {
+
+/* weight of the past on each Hello */
+static const double kDeliveryDecay = 0.9;
+/* ETX is capped at 1/kMinDeliveryRatio */
+static const double kMinDeliveryRatio = 0.1;
+static const double kRttAlpha = 0.125;
+
+void LinkMetric::OnHello(uint64_t seq) {
+  if (m_lastSeq == 0 || seq <= m_lastSeq) {
+    /* first Hello, or the neighbor restarted: start over */
+    m_lastSeq = seq;
+    m_received = m_expected = 1;
+    return;
+  }
+  m_received = kDeliveryDecay * m_received + 1;
+  m_expected = kDeliveryDecay * m_expected + (seq - m_lastSeq);
+  m_lastSeq = seq;
+}
+
+void LinkMetric::OnRtt(time::nanoseconds rtt) {
+  double ms = time::duration_cast<time::microseconds>(rtt).count() / 1000.0;
+  if (m_srttMs == 0)
+    m_srttMs = ms;
+  else
+    m_srttMs = (1 - kRttAlpha) * m_srttMs + kRttAlpha * ms;
+}
+
+bool LinkMetric::UpdateCost(time::milliseconds rttRef, double hysteresis) {
+  double etx = 1.0 / std::max(GetDeliveryRatio(), kMinDeliveryRatio);
+  double rttFactor = rttRef.count() > 0 ? std::max(1.0, m_srttMs / rttRef.count()) : 1.0;
+  uint32_t cost = std::lround(kScale * etx * rttFactor);
+
+  uint32_t diff = cost > m_cost ? cost - m_cost : m_cost - cost;
+  if (diff == 0 || diff <= hysteresis * m_cost)
+    return false;
+  m_cost = cost;
+  return true;
+}
+
+} // namespace ndvr
+} // namespace ndn
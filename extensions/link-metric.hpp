@@ -0,0 +1,59 @@
+#ifndef _LINKMETRIC_H_
+#define _LINKMETRIC_H_
+
+#include <cstdint>
+
+#include <ndn-cxx/util/time.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/**
+ * @brief link quality estimator of a neighbor
+ *
+ *   Combines two measurements into the cost of the link to the neighbor:
+ *
+ *   - Hello delivery ratio: Hellos carry a sequence number, so the gaps
+ *     tell how many of the neighbor's Hellos were lost. Both counts decay
+ *     on each Hello, so the ratio follows the recent history. As in ETX,
+ *     the expected number of transmissions is 1/ratio (we only see the
+ *     neighbor->us direction, the link is assumed symmetric).
+ *   - RTT of the DvInfo exchange, smoothed as in TCP (alpha=1/8). It
+ *     includes the neighbor's reply delay, so it only adds to the cost
+ *     when it is above a reference RTT.
+ *
+ *   cost = kScale * ETX * max(1, srtt/rttRef), ie, kScale for a perfect
+ *   link. The advertised cost only changes when the computed one moves
+ *   more than the hysteresis (fraction of the current cost), so that
+ *   routes do not flap on every measurement.
+ */
+class LinkMetric {
+public:
+  static const uint32_t kScale = 10;
+
+  void OnHello(uint64_t seq);
+  void OnRtt(time::nanoseconds rtt);
+
+  /* recomputes the cost, returns true if the advertised one has changed */
+  bool UpdateCost(time::milliseconds rttRef, double hysteresis);
+
+  uint32_t GetCost() const {
+    return m_cost;
+  }
+
+  double GetDeliveryRatio() const {
+    return m_expected > 0 ? m_received / m_expected : 1.0;
+  }
+
+private:
+  uint64_t m_lastSeq = 0;
+  double m_received = 0;
+  double m_expected = 0;
+  double m_srttMs = 0;
+  uint32_t m_cost = kScale;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _LINKMETRIC_H_
@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include "name-tree.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+const uint32_t NameTree::kInvalid;
+const uint32_t NameTree::kRoot;
+
+static bool
+ChildLess(const std::pair<name::Component, uint32_t>& child, const name::Component& comp) {
+  return child.first < comp;
+}
+
+NameTree::NameTree()
+  : m_nodes(1)
+  , m_nEntries(0)
+{
+}
+
+uint32_t NameTree::FindChild(uint32_t node, const name::Component& comp) const {
+  const auto& children = m_nodes[node].children;
+  auto it = std::lower_bound(children.begin(), children.end(), comp, ChildLess);
+  if (it == children.end() || it->first != comp)
+    return kInvalid;
+  return it->second;
+}
+
+uint32_t NameTree::AddChild(uint32_t node, const name::Component& comp) {
+  uint32_t child = FindChild(node, comp);
+  if (child != kInvalid)
+    return child;
+
+  if (!m_freeNodes.empty()) {
+    child = m_freeNodes.back();
+    m_freeNodes.pop_back();
+  } else {
+    child = m_nodes.size();
+    m_nodes.emplace_back();
+  }
+  m_nodes[child].comp = comp;
+  m_nodes[child].parent = node;
+
+  auto& children = m_nodes[node].children;
+  auto it = std::lower_bound(children.begin(), children.end(), comp, ChildLess);
+  children.emplace(it, comp, child);
+  return child;
+}
+
+uint32_t NameTree::FindNode(const Name& name) const {
+  uint32_t node = kRoot;
+  for (const auto& comp : name) {
+    node = FindChild(node, comp);
+    if (node == kInvalid)
+      return kInvalid;
+  }
+  return node;
+}
+
+void NameTree::Insert(const Name& name, uint32_t key) {
+  uint32_t node = kRoot;
+  for (const auto& comp : name)
+    node = AddChild(node, comp);
+  if (!m_nodes[node].hasEntry)
+    m_nEntries++;
+  m_nodes[node].hasEntry = true;
+  m_nodes[node].key = key;
+}
+
+void NameTree::Erase(const Name& name) {
+  uint32_t node = FindNode(name);
+  if (node == kInvalid || !m_nodes[node].hasEntry)
+    return;
+  m_nodes[node].hasEntry = false;
+  m_nodes[node].key = kInvalid;
+  m_nEntries--;
+  Prune(node);
+}
+
+void NameTree::Prune(uint32_t node) {
+  /* release nodes that have no entry and no children, up to the root */
+  while (node != kRoot && !m_nodes[node].hasEntry && m_nodes[node].children.empty()) {
+    uint32_t parent = m_nodes[node].parent;
+    auto& children = m_nodes[parent].children;
+    auto it = std::lower_bound(children.begin(), children.end(), m_nodes[node].comp, ChildLess);
+    children.erase(it);
+
+    m_nodes[node] = Node();
+    m_freeNodes.push_back(node);
+    node = parent;
+  }
+}
+
+bool NameTree::FindExact(const Name& name, uint32_t& key) const {
+  uint32_t node = FindNode(name);
+  if (node == kInvalid || !m_nodes[node].hasEntry)
+    return false;
+  key = m_nodes[node].key;
+  return true;
+}
+
+bool NameTree::FindLongestPrefix(const Name& name, uint32_t& key) const {
+  uint32_t node = kRoot;
+  uint32_t match = m_nodes[kRoot].hasEntry ? kRoot : kInvalid;
+  for (const auto& comp : name) {
+    node = FindChild(node, comp);
+    if (node == kInvalid)
+      break;
+    if (m_nodes[node].hasEntry)
+      match = node;
+  }
+  if (match == kInvalid)
+    return false;
+  key = m_nodes[match].key;
+  return true;
+}
+
+void NameTree::ListSubtree(const Name& prefix, std::vector<uint32_t>& keys) const {
+  uint32_t start = FindNode(prefix);
+  if (start == kInvalid)
+    return;
+
+  std::vector<uint32_t> stack(1, start);
+  while (!stack.empty()) {
+    uint32_t node = stack.back();
+    stack.pop_back();
+    if (m_nodes[node].hasEntry)
+      keys.push_back(m_nodes[node].key);
+    for (auto it = m_nodes[node].children.rbegin(); it != m_nodes[node].children.rend(); ++it)
+      stack.push_back(it->second);
+  }
+}
+
+} // namespace ndvr
+} // namespace ndn
@@ -0,0 +1,64 @@
+#ifndef _NAMETREE_H_
+#define _NAMETREE_H_
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/name.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/**
+ * @brief component-wise trie of name prefixes
+ *
+ *   Each node is one name component; nodes holding a name prefix carry
+ *   the key of that prefix (ie, its PrefixId in the RoutingTable).
+ *   Nodes live in a contiguous vector and refer to each other by index,
+ *   children are kept sorted to be found by binary search. Supports exact
+ *   match, longest prefix match and enumeration of all prefixes under a
+ *   given name.
+ */
+class NameTree {
+public:
+  NameTree();
+
+  void Insert(const Name& name, uint32_t key);
+  void Erase(const Name& name);
+  bool FindExact(const Name& name, uint32_t& key) const;
+  bool FindLongestPrefix(const Name& name, uint32_t& key) const;
+  void ListSubtree(const Name& prefix, std::vector<uint32_t>& keys) const;
+
+  size_t size() const {
+    return m_nEntries;
+  }
+
+private:
+  static const uint32_t kInvalid = std::numeric_limits<uint32_t>::max();
+  static const uint32_t kRoot = 0;
+
+  struct Node {
+    name::Component comp;
+    uint32_t parent = kInvalid;
+    /* sorted by component */
+    std::vector<std::pair<name::Component, uint32_t>> children;
+    bool hasEntry = false;
+    uint32_t key = kInvalid;
+  };
+
+  uint32_t FindChild(uint32_t node, const name::Component& comp) const;
+  uint32_t AddChild(uint32_t node, const name::Component& comp);
+  uint32_t FindNode(const Name& name) const;
+  void Prune(uint32_t node);
+
+private:
+  std::vector<Node> m_nodes;
+  std::vector<uint32_t> m_freeNodes;
+  size_t m_nEntries;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _NAMETREE_H_
@@ -27,7 +27,41 @@ public:
       .AddAttribute("SyncDataRounds", "Deprecated: Number of rounds to run the sync data process", IntegerValue(0),
                     MakeIntegerAccessor(&NdvrApp::syncDataRounds_), MakeIntegerChecker<int32_t>())
       .AddAttribute("EnableUnicastFace", "Enable dynamic creating unicast faces", BooleanValue(false),
-                    MakeBooleanAccessor(&NdvrApp::unicastFaces_), MakeBooleanChecker());
+                    MakeBooleanAccessor(&NdvrApp::unicastFaces_), MakeBooleanChecker())
+      .AddAttribute("EnableDeltaDvInfo", "Request only the routing entries changed since the last DvInfo received", BooleanValue(false),
+                    MakeBooleanAccessor(&NdvrApp::deltaDvInfo_), MakeBooleanChecker())
+      .AddAttribute("DvInfoSegmentSize", "Maximum bytes of encoded DvInfo carried by each Data segment", UintegerValue(1000),
+                    MakeUintegerAccessor(&NdvrApp::dvinfoSegmentSize_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("FibBackend", "How routes are installed in the FIB: management (NFD commands) or direct (nfd::Fib)", StringValue("management"),
+                    MakeStringAccessor(&NdvrApp::fibBackend_), MakeStringChecker())
+      .AddAttribute("EnableFibAggregation", "Do not install the prefixes whose next hops are the same as those of their closest covering prefix", BooleanValue(false),
+                    MakeBooleanAccessor(&NdvrApp::fibAggregation_), MakeBooleanChecker())
+      .AddAttribute("SigningMode", "How DvInfo is signed: rsa, ecdsa (P-256 DSK), hmac (shared key) or digest (SHA-256 only)", StringValue("rsa"),
+                    MakeStringAccessor(&NdvrApp::signingMode_), MakeStringChecker())
+      .AddAttribute("HmacKey", "Key shared by the routers of the neighborhood, used by the hmac signing mode", StringValue(""),
+                    MakeStringAccessor(&NdvrApp::hmacKey_), MakeStringChecker())
+      .AddAttribute("MaxVerificationsInFlight", "Maximum number of DvInfo signature verifications running at the same time", UintegerValue(8),
+                    MakeUintegerAccessor(&NdvrApp::maxVerificationsInFlight_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("EnableAdaptiveHello", "Double the Hello interval up to HelloIntervalMax while stable and send each Hello at a random time in the second half of it", BooleanValue(false),
+                    MakeBooleanAccessor(&NdvrApp::adaptiveHello_), MakeBooleanChecker())
+      .AddAttribute("HelloIntervalMax", "Longest Hello interval (seconds) reached while the neighbors and the routing table are stable", UintegerValue(5),
+                    MakeUintegerAccessor(&NdvrApp::helloIntervalMax_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("HelloRedundancy", "Skip a Hello after overhearing this many neighbors announce the same digest, once at HelloIntervalMax with EnableAdaptiveHello (0 disables)", UintegerValue(0),
+                    MakeUintegerAccessor(&NdvrApp::helloRedundancy_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("HelloPriorityNeighbors", "Number of neighbors announced in each Hello to request our DvInfo right away", UintegerValue(2),
+                    MakeUintegerAccessor(&NdvrApp::helloPriorityNeighbors_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("DvInfoMaxRetx", "Maximum number of retransmissions of a DvInfo Interest", UintegerValue(3),
+                    MakeUintegerAccessor(&NdvrApp::dvinfoMaxRetx_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("EnableLinkMetric", "Cost of the links from the Hello delivery ratio and the DvInfo RTT instead of hop count", BooleanValue(false),
+                    MakeBooleanAccessor(&NdvrApp::linkMetric_), MakeBooleanChecker())
+      .AddAttribute("MaxSettlingTime", "Maximum time (milliseconds) a route cost change is held to aggregate updates before reaching the FIB (0 disables)", UintegerValue(0),
+                    MakeUintegerAccessor(&NdvrApp::maxSettlingTime_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("TriggeredHelloInterval", "Minimum time (milliseconds) between Hellos triggered by routing table changes (0 disables them)", UintegerValue(0),
+                    MakeUintegerAccessor(&NdvrApp::triggeredHelloInterval_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("RemovedNeighborCacheSize", "Maximum number of removed neighbors whose state is kept in case they come back", UintegerValue(32),
+                    MakeUintegerAccessor(&NdvrApp::removedNeighborCacheSize_), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("RemovedNeighborTtl", "Time (seconds) the state of a removed neighbor is kept", UintegerValue(60),
+                    MakeUintegerAccessor(&NdvrApp::removedNeighborTtl_), MakeUintegerChecker<uint32_t>());
     return tid;
   }
 
@@ -45,6 +79,30 @@ public:
     signingInfo_ = signingInfo;
   }
 
+  uint64_t GetHelloSentCount() {
+    return m_instance ? m_instance->GetHelloSentCount() : 0;
+  }
+
+  uint64_t GetHelloSuppressedCount() {
+    return m_instance ? m_instance->GetHelloSuppressedCount() : 0;
+  }
+
+  uint64_t GetHelloTriggeredCount() {
+    return m_instance ? m_instance->GetHelloTriggeredCount() : 0;
+  }
+
+  uint64_t GetDvInfoRecoveredCount() {
+    return m_instance ? m_instance->GetDvInfoRecoveredCount() : 0;
+  }
+
+  uint64_t GetDvInfoStaleCount() {
+    return m_instance ? m_instance->GetDvInfoStaleCount() : 0;
+  }
+
+  uint64_t GetDvInfoAbandonedCount() {
+    return m_instance ? m_instance->GetDvInfoAbandonedCount() : 0;
+  }
+
   void EnableDSKMaxSecs(uint32_t x) {
     maxSecsDSK_ = x;
   }
@@ -56,6 +114,23 @@ protected:
   virtual void StartApplication() {
     m_instance.reset(new ::ndn::ndvr::Ndvr(signingInfo_, network_, routerName_, namePrefixes_));
     m_instance->EnableUnicastFaces(unicastFaces_);
+    m_instance->EnableDeltaDvInfo(deltaDvInfo_);
+    m_instance->SetDvInfoSegmentSize(dvinfoSegmentSize_);
+    m_instance->SetFibBackend(fibBackend_);
+    m_instance->EnableFibAggregation(fibAggregation_);
+    m_instance->SetSigningMode(signingMode_);
+    if (!hmacKey_.empty())
+      m_instance->SetHmacKey(hmacKey_);
+    m_instance->SetMaxVerificationsInFlight(maxVerificationsInFlight_);
+    m_instance->EnableAdaptiveHello(adaptiveHello_);
+    m_instance->SetHelloIntervalMax(helloIntervalMax_);
+    m_instance->SetHelloRedundancy(helloRedundancy_);
+    m_instance->SetHelloPriorityNeighbors(helloPriorityNeighbors_);
+    m_instance->SetDvInfoMaxRetx(dvinfoMaxRetx_);
+    m_instance->EnableLinkMetric(linkMetric_);
+    m_instance->SetMaxSettlingTime(maxSettlingTime_);
+    m_instance->SetTriggeredHelloInterval(triggeredHelloInterval_);
+    m_instance->SetRemovedNeighborCache(removedNeighborCacheSize_, removedNeighborTtl_);
     if (maxSecsDSK_!=0 || maxSizeDSK_!=0) {
       m_instance->EnableDSK(true);
       m_instance->SetMaxSizeDSK(maxSizeDSK_);
@@ -77,6 +152,23 @@ private:
   std::vector<std::string> namePrefixes_;
   uint32_t syncDataRounds_;      // number of rounds to sync data (for data sync experiment)
   bool unicastFaces_;
+  bool deltaDvInfo_;
+  uint32_t dvinfoSegmentSize_;
+  std::string fibBackend_;
+  bool fibAggregation_;
+  std::string signingMode_;
+  std::string hmacKey_;
+  uint32_t maxVerificationsInFlight_;
+  bool adaptiveHello_;
+  uint32_t helloIntervalMax_;
+  uint32_t helloRedundancy_;
+  uint32_t helloPriorityNeighbors_;
+  uint32_t dvinfoMaxRetx_;
+  bool linkMetric_;
+  uint32_t maxSettlingTime_;
+  uint32_t triggeredHelloInterval_;
+  uint32_t removedNeighborCacheSize_;
+  uint32_t removedNeighborTtl_;
   uint32_t maxSecsDSK_ = 0;
   uint32_t maxSizeDSK_ = 0;
 };
@@ -3,45 +3,91 @@
 
 #include "ndvr-message.pb.h"
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
 namespace ndn {
 namespace ndvr {
 
-inline void EncodeDvInfo(RoutingTable& v, proto::DvInfo* dvinfo_proto) {
-  for (auto it = v.begin(); it != v.end(); ++it) {
-    auto* entry = dvinfo_proto->add_entry();
-    entry->set_prefix(it->first);
-    entry->set_seq(it->second.GetSeqNum());
-    entry->set_cost(it->second.GetCost());
-  }
-}
+/** @brief One DvInfo entry whose prefix points into the encoded buffer */
+struct DvInfoEntryView {
+  const char* prefix = nullptr;
+  size_t prefix_size = 0;
+  uint64_t seq = 0;
+  uint32_t cost = 0;
+};
 
-inline void EncodeDvInfo(RoutingTable& v, std::string& out) {
-  proto::DvInfo dvinfo_proto;
-  EncodeDvInfo(v, &dvinfo_proto);
-  dvinfo_proto.AppendToString(&out);
-}
+/** @brief Walks an encoded proto::DvInfo and calls f(const DvInfoEntryView&)
+ * for each entry, without building the protobuf message nor copying the
+ * prefixes (the views are only valid during the call).
+ *
+ * Returns false if buf is not a valid DvInfo. Entries before the error
+ * were already visited, so callers may want a first pass with a no-op f.
+ */
+template<typename F>
+inline bool ForEachDvInfoEntry(const uint8_t* buf, size_t buf_size,
+                               uint64_t& version, uint64_t& base_version, F&& f) {
+  using google::protobuf::io::CodedInputStream;
+  using google::protobuf::internal::WireFormatLite;
+  /* tag = field_number << 3 | wire_type (see ndvr-message.proto) */
+  const uint32_t kTagEntry = (1 << 3) | WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+  const uint32_t kTagVersion = (2 << 3) | WireFormatLite::WIRETYPE_VARINT;
+  const uint32_t kTagBaseVersion = (3 << 3) | WireFormatLite::WIRETYPE_VARINT;
+  const uint32_t kTagEntryPrefix = (1 << 3) | WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+  const uint32_t kTagEntrySeq = (2 << 3) | WireFormatLite::WIRETYPE_VARINT;
+  const uint32_t kTagEntryCost = (3 << 3) | WireFormatLite::WIRETYPE_VARINT;
 
-inline RoutingTable DecodeDvInfo(const proto::DvInfo& dvinfo_proto) {
-  RoutingTable dvinfo;
-  for (int i = 0; i < dvinfo_proto.entry_size(); ++i) {
-    const auto& entry = dvinfo_proto.entry(i);
-    auto prefix = entry.prefix();
-    auto seq = entry.seq();
-    auto cost = entry.cost();
-    RoutingEntry re = RoutingEntry(prefix, seq, cost);
-    dvinfo.insert(re);
+  CodedInputStream in(buf, buf_size);
+  version = base_version = 0;
+  uint32_t tag;
+  while ((tag = in.ReadTag()) != 0) {
+    if (tag == kTagVersion) {
+      if (!in.ReadVarint64(&version))
+        return false;
+    } else if (tag == kTagBaseVersion) {
+      if (!in.ReadVarint64(&base_version))
+        return false;
+    } else if (tag == kTagEntry) {
+      uint32_t len;
+      if (!in.ReadVarint32(&len))
+        return false;
+      auto limit = in.PushLimit(len);
+      DvInfoEntryView entry;
+      while ((tag = in.ReadTag()) != 0) {
+        if (tag == kTagEntryPrefix) {
+          uint32_t n;
+          const void* data;
+          int avail;
+          if (!in.ReadVarint32(&n))
+            return false;
+          if (n > 0) {
+            if (!in.GetDirectBufferPointer(&data, &avail) || static_cast<uint32_t>(avail) < n)
+              return false;
+            entry.prefix = static_cast<const char*>(data);
+            in.Skip(n);
+          }
+          entry.prefix_size = n;
+        } else if (tag == kTagEntrySeq) {
+          if (!in.ReadVarint64(&entry.seq))
+            return false;
+        } else if (tag == kTagEntryCost) {
+          if (!in.ReadVarint32(&entry.cost))
+            return false;
+        } else if (!WireFormatLite::SkipField(&in, tag)) {
+          return false;
+        }
+      }
+      if (!in.ConsumedEntireMessage())
+        return false;
+      in.PopLimit(limit);
+      f(entry);
+    } else if (!WireFormatLite::SkipField(&in, tag)) {
+      return false;
+    }
   }
-  return dvinfo;
+  return in.ConsumedEntireMessage();
 }
 
-inline RoutingTable DecodeDvInfo(const void* buf, size_t buf_size) {
-  proto::DvInfo dvinfo_proto;
-  if (!dvinfo_proto.ParseFromArray(buf, buf_size)) {
-    RoutingTable res;
-    return res;
-  }
-  return DecodeDvInfo(dvinfo_proto);
-}
 }  // namespace ndvr
 }  // namespace ndn
 
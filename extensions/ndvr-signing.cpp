@@ -0,0 +1,69 @@
+#include "ndvr-signing.hpp"
+
+#include <algorithm>
+
+#include <ndn-cxx/encoding/buffer-stream.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/security/transform/buffer-source.hpp>
+#include <ndn-cxx/security/transform/hmac-filter.hpp>
+#include <ndn-cxx/security/transform/stream-sink.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+bool ParseSigningMode(const std::string& str, SigningMode& mode) {
+  if (str == "rsa")
+    mode = SigningMode::RSA;
+  else if (str == "ecdsa")
+    mode = SigningMode::ECDSA;
+  else if (str == "hmac")
+    mode = SigningMode::HMAC;
+  else if (str == "digest")
+    mode = SigningMode::DIGEST;
+  else
+    return false;
+  return true;
+}
+
+std::unique_ptr<KeyParams> MakeKeyParams(SigningMode mode) {
+  if (mode == SigningMode::ECDSA)
+    return std::unique_ptr<KeyParams>(new EcKeyParams(256));
+  return std::unique_ptr<KeyParams>(new RsaKeyParams());
+}
+
+ConstBufferPtr HmacSigner::Compute(const uint8_t* buf, size_t size) const {
+  using namespace ndn::security::transform;
+
+  OBufferStream os;
+  bufferSource(buf, size)
+    >> hmacFilter(DigestAlgorithm::SHA256,
+                  reinterpret_cast<const uint8_t*>(m_key.data()), m_key.size())
+    >> streamSink(os);
+  return os.buf();
+}
+
+void HmacSigner::Sign(Data& data) const {
+  /* same steps as KeyChain::sign(): encode the signed portion, then
+   * append the SignatureValue */
+  data.setSignature(Signature(SignatureInfo(tlv::SignatureHmacWithSha256, KeyLocator(m_keyName))));
+  EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  ConstBufferPtr sig = Compute(encoder.buf(), encoder.size());
+  data.wireEncode(encoder, Block(tlv::SignatureValue, sig));
+}
+
+bool HmacSigner::Verify(const Data& data) const {
+  const Signature& sig = data.getSignature();
+  if (sig.getType() != tlv::SignatureHmacWithSha256 || !sig.hasKeyLocator() ||
+      sig.getKeyLocator().getName() != m_keyName)
+    return false;
+
+  /* the signed portion is the Data value up to the SignatureValue */
+  const Block& wire = data.wireEncode();
+  ConstBufferPtr expected = Compute(wire.value(), wire.value_size() - sig.getValue().size());
+  return expected->size() == sig.getValue().value_size() &&
+         std::equal(expected->begin(), expected->end(), sig.getValue().value());
+}
+
+} // namespace ndvr
+} // namespace ndn
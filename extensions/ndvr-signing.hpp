@@ -0,0 +1,64 @@
+#ifndef _NDVR_SIGNING_HPP_
+#define _NDVR_SIGNING_HPP_
+
+#include <memory>
+#include <string>
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/security/key-params.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+/**
+ * @brief how DvInfo Data is signed and validated
+ *
+ *   - RSA: router's key (or RSA DSK), checked by the validator rules
+ *   - ECDSA: ECDSA P-256 DSK certified by the router's key, checked by
+ *     the validator rules
+ *   - HMAC: HMAC-SHA256 with a key shared by the routers of the
+ *     neighborhood
+ *   - DIGEST: SHA-256 digest only, no authentication (trusted testbeds)
+ */
+enum class SigningMode {
+  RSA,
+  ECDSA,
+  HMAC,
+  DIGEST,
+};
+
+/* "rsa", "ecdsa", "hmac" or "digest"; returns false for unknown modes */
+bool ParseSigningMode(const std::string& str, SigningMode& mode);
+
+/* key parameters of the DSKs created for the given mode */
+std::unique_ptr<KeyParams> MakeKeyParams(SigningMode mode);
+
+/* HMAC-SHA256 signer/verifier of Data packets, the KeyLocator carries
+ * the key name so that routers can tell which shared key was used */
+class HmacSigner {
+public:
+  HmacSigner(const Name& keyName, const std::string& key)
+    : m_keyName(keyName)
+    , m_key(key)
+  {
+  }
+
+  void Sign(Data& data) const;
+  bool Verify(const Data& data) const;
+
+  const Name& GetKeyName() const {
+    return m_keyName;
+  }
+
+private:
+  ConstBufferPtr Compute(const uint8_t* buf, size_t size) const;
+
+private:
+  Name m_keyName;
+  std::string m_key;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _NDVR_SIGNING_HPP_
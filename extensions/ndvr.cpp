@@ -5,7 +5,7 @@
 #include <cmath>
 #include <boost/algorithm/string.hpp> 
 #include <algorithm>
-#include <boost/uuid/sha1.hpp>
+#include <set>
 #include <ns3/simulator.h>
 #include <ns3/log.h>
 #include <ns3/ptr.h>
@@ -13,6 +13,8 @@
 #include <ns3/node-list.h>
 #include <ns3/ndnSIM/helper/ndn-stack-helper.hpp>
 #include <ndn-cxx/lp/tags.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
+#include <ndn-cxx/util/string-helper.hpp>
 
 #include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
@@ -38,7 +40,6 @@ Ndvr::Ndvr(const ndn::security::SigningInfo& signingInfo, Name network, Name rou
   , m_localRTInterval(1)
   , m_localRTTimeout(1)
   , m_rengine(rdevice_())
-  , m_pivot(m_neighMap.end())
 {
   buildRouterPrefix();
 
@@ -53,7 +54,7 @@ Ndvr::Ndvr(const ndn::security::SigningInfo& signingInfo, Name network, Name rou
 
   for (std::vector<std::string>::iterator it = npv.begin() ; it != npv.end(); ++it) {
     RoutingEntry routingEntry;
-    routingEntry.SetName(*it);
+    routingEntry.SetPrefixId(m_routingTable.InternPrefix(*it));
     routingEntry.SetSeqNum(1);
     routingEntry.SetCost(0);
     routingEntry.SetFaceId(0); /* directly connected */
@@ -80,6 +81,9 @@ Ndvr::Ndvr(const ndn::security::SigningInfo& signingInfo, Name network, Name rou
 }
 
 void Ndvr::Start() {
+  /* reject the configuration now rather than on the first DvInfo reply */
+  if (m_signingMode == SigningMode::HMAC && !m_hmacSigner)
+    throw Error("HMAC signing mode requires a shared key (HmacKey)");
   SendHelloInterest();
   ManageSigningInfo();
 }
@@ -94,14 +98,27 @@ void Ndvr::run() {
 void Ndvr::registerNeighborPrefix(NeighborEntry& neighbor, uint64_t oldFaceId, uint64_t newFaceId) {
   using namespace ns3;
   using namespace ns3::ndn;
-  NS_LOG_DEBUG("AddNeighPrefix=" << neighbor.GetName() << " oldFaceId=" << oldFaceId << " newFaceId=" << newFaceId);
+  NS_LOG_DEBUG("AddNeighPrefix=" << PrefixUri(neighbor.GetPrefixId()) << " oldFaceId=" << oldFaceId << " newFaceId=" << newFaceId);
 
   int32_t metric = CalculateCostToNeigh(neighbor, 0);
 
   if (oldFaceId != 0) {
-    m_routingTable.unregisterPrefix(neighbor.GetName(), oldFaceId);
+    m_routingTable.unregisterPrefix(neighbor.GetPrefixId(), oldFaceId);
+    if (oldFaceId != newFaceId)
+      ReleaseNeighborFace(oldFaceId, neighbor.GetPrefixId());
   }
-  m_routingTable.registerPrefix(neighbor.GetName(), newFaceId, metric);
+  m_routingTable.registerPrefix(neighbor.GetPrefixId(), newFaceId, metric);
+}
+
+void Ndvr::ReleaseNeighborFace(uint64_t faceId, PrefixId neigh) {
+  /* the face may still be used by other neighbors (eg, the multicast face) */
+  for (auto& it : m_neighMap) {
+    if (it.first != neigh && it.second.GetFaceId() == faceId)
+      return;
+  }
+  /* otherwise, nothing is reachable through it anymore: withdraw all the
+   * routes through it, so the FIB queue does not take them as installed */
+  m_routingTable.unregisterFace(faceId);
 }
 
 void
@@ -127,8 +144,10 @@ Ndvr::registerPrefixes() {
 
     auto addr = device->GetAddress();
     if (m_enableUnicastFaces && Mac48Address::IsMatchingType(addr)) {
-      m_macaddr = boost::lexical_cast<std::string>(Mac48Address::ConvertFrom(addr));
-      NS_LOG_DEBUG("Save mac =" << m_macaddr);
+      uint8_t mac[6];
+      Mac48Address::ConvertFrom(addr).CopyTo(mac);
+      m_macaddr.assign(reinterpret_cast<const char*>(mac), sizeof(mac));
+      NS_LOG_DEBUG("Save mac =" << Mac48Address::ConvertFrom(addr));
     }
   }
 
@@ -140,14 +159,35 @@ Ndvr::getSigningInfo()
   return (m_enableDSK) ? m_signingInfoDSK : m_signingInfo;
 }
 
+void
+Ndvr::SignDvInfo(ndn::Data& data) {
+  switch (m_signingMode) {
+  case SigningMode::HMAC:
+    /* the key was checked on Start() */
+    m_hmacSigner->Sign(data);
+    break;
+  case SigningMode::DIGEST:
+    m_keyChain.sign(data, ndn::security::signingWithSha256());
+    break;
+  default:
+    m_keyChain.sign(data, getSigningInfo());
+  }
+}
+
 void
 Ndvr::ManageSigningInfo() {
   managesigninginfo_event.cancel();
 
-  /* Sanity check */
+  /* Sanity check: the ECDSA signing mode always signs with a DSK, which
+   * is only rotated if maxSecs/maxSize are set; HMAC and digest do not
+   * use keys from the KeyChain */
+  if (m_signingMode == SigningMode::ECDSA)
+    m_enableDSK = true;
+  if (m_signingMode == SigningMode::HMAC || m_signingMode == SigningMode::DIGEST)
+    m_enableDSK = false;
   if (!m_enableDSK)
     return;
-  if (m_maxSecsDSK==0 && m_maxSizeDSK==0) {
+  if (m_maxSecsDSK==0 && m_maxSizeDSK==0 && m_signingMode != SigningMode::ECDSA) {
     m_enableDSK = false;
     return;
   }
@@ -170,7 +210,8 @@ Ndvr::ManageSigningInfo() {
 
 void
 Ndvr::createDSK(std::string subjectName) {
-  ndn::security::Key dsk = m_keyChain.createKey(m_keyChain.getPib().getIdentity(m_signingInfo.getSignerName()));
+  ndn::security::Key dsk = m_keyChain.createKey(m_keyChain.getPib().getIdentity(m_signingInfo.getSignerName()),
+                                                *MakeKeyParams(m_signingMode));
 
   ndn::Name certificateName = dsk.getName();
   certificateName.append("DSK");
@@ -198,94 +239,199 @@ Ndvr::createDSK(std::string subjectName) {
   m_lastDSKCert = time::steady_clock::now();
 }
 
-std::string
-Ndvr::GetNeighborToken() {
-  std::string res;
-
-  if (!m_neighMap.size()) {
-    m_pivot = m_neighMap.end();
-    return res;
-  }
-
-  if (m_pivot == m_neighMap.end() || ++m_pivot == m_neighMap.end()) {
-    m_pivot = m_neighMap.begin();
-    /* go to a random position */
-    std::uniform_int_distribution<int> rand(0, m_neighMap.size() - 1);
-    int r = rand(m_rengine);
-    for (;r>0;r--)
-      m_pivot++;
+void
+Ndvr::GetNeighborToken(proto::Hello& hello) {
+  /* the next m_helloPriorityNeighbors neighbors of the ring, skipping the
+   * repeated ones when a new round starts in the middle of the token */
+  size_t n = std::min<size_t>(m_helloPriorityNeighbors, m_neighRing.size());
+  for (size_t i = 0; i < 2*n && static_cast<size_t>(hello.neighbor_size()) < n; i++) {
+    const std::string& uri = PrefixUri(m_neighRing.Next(m_rengine));
+    if (std::find(hello.neighbor().begin(), hello.neighbor().end(), uri) == hello.neighbor().end())
+      hello.add_neighbor(uri);
   }
-  res.append(m_pivot->first);
-
-  if (m_neighMap.size() == 1)
-    return res;
+}
 
-  if (++m_pivot == m_neighMap.end()) {
-    m_pivot = m_neighMap.begin();
-  }
-  res.append("&");
-  res.append(m_pivot->first);
+void
+Ndvr::TriggerHello() {
+  /* only once started (ie, there is a Hello event) */
+  if (m_triggeredHelloInterval <= time::milliseconds::zero() || !sendhello_event)
+    return;
+  /* changes until the triggered Hello goes out are carried by it */
+  if (triggeredhello_event)
+    return;
 
-  return res;
+  /* at least m_triggeredHelloInterval between triggered Hellos, plus some
+   * jitter so that neighbors reacting to the same change do not collide */
+  auto now = time::steady_clock::now();
+  auto earliest = m_lastTriggeredHello + m_triggeredHelloInterval;
+  time::nanoseconds delay = earliest > now ? time::duration_cast<time::nanoseconds>(earliest - now) : time::nanoseconds::zero();
+  std::uniform_int_distribution<int> jitter(0, 20000);  /* microseconds */
+  delay += time::microseconds(jitter(m_rengine));
+  triggeredhello_event = m_scheduler.schedule(delay, [this] {
+      m_lastTriggeredHello = time::steady_clock::now();
+      m_helloTriggered++;
+      SendHelloInterest(true);
+    });
 }
 
 void
-Ndvr::SendHelloInterest() {
-  /* First of all, cancel any previously scheduled events */
-  sendhello_event.cancel();
+Ndvr::SendHelloInterest(bool triggered) {
+  /* a triggered Hello goes out on its own, leaving the periodic ones (their
+   * schedule, back-off and suppression) as they are */
+  if (!triggered)
+    sendhello_event.cancel();
+
+  if (!triggered && SuppressHello()) {
+    NS_LOG_INFO("Suppressing Hello, overheard " << m_helloConsistentHeard << " consistent Hellos");
+    m_helloSuppressed++;
+    m_helloLastSuppressed = true;
+    m_helloConsistentHeard = 0;
+    IncreaseHelloInterval();
+    ScheduleHelloInterest();
+    return;
+  }
+  if (!triggered) {
+    m_helloLastSuppressed = false;
+    m_helloConsistentHeard = 0;
+    m_helloSent++;
+  }
 
   Name name = Name(kNdvrHelloPrefix);
   name.append(getRouterPrefix());
-  name.appendNumber(m_routingTable.size());
-  name.append(m_routingTable.GetDigest());
-  name.appendNumber(m_routingTable.GetVersion());
-  NS_LOG_INFO("Sending Interest " << name);
+
+  proto::Hello hello;
+  hello.set_num_prefixes(m_routingTable.size());
+  hello.set_digest(m_routingTable.GetDigest());
+  hello.set_version(m_routingTable.GetVersion());
+  if (m_neighMap.size() > 0)
+    GetNeighborToken(hello);
+  if (m_enableUnicastFaces)
+    hello.set_mac(m_macaddr);
+  hello.set_seq(++m_helloSeq);
+  hello.set_interval(MaxHelloGap());
+  std::string params;
+  hello.SerializeToString(&params);
+  NS_LOG_INFO("Sending Interest " << name << " numPrefixes=" << hello.num_prefixes()
+              << " digest=" << toHex(reinterpret_cast<const uint8_t*>(hello.digest().data()), hello.digest().size())
+              << " version=" << hello.version());
 
   Interest interest = Interest();
   interest.setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
   interest.setName(name);
   interest.setCanBePrefix(false);
   interest.setInterestLifetime(time::milliseconds(0));
-  std::string params;
-  if (m_neighMap.size() > 0) {
-    auto neighbors_token = GetNeighborToken();
-    NS_LOG_INFO("neighbors_token " << neighbors_token);
-    params = neighbors_token;
-  }
-  if (m_enableUnicastFaces) {
-    params = params + "&" + m_macaddr;
-  }
-  if (!params.empty()) {
-    interest.setApplicationParameters(reinterpret_cast<const uint8_t*>(params.data()), params.size());
-  }
+  interest.setApplicationParameters(reinterpret_cast<const uint8_t*>(params.data()), params.size());
 
   m_face.expressInterest(interest, [](const Interest&, const Data&) {},
                         [](const Interest&, const lp::Nack&) {},
                         [](const Interest&) {});
 
-  sendhello_event = m_scheduler.schedule(time::seconds(m_helloIntervalCur),
+  if (triggered)
+    return;
+  /* nothing has changed since the last Hello (otherwise ResetHelloInterval()
+   * would have been called), so back off */
+  IncreaseHelloInterval();
+  ScheduleHelloInterest();
+}
+
+bool
+Ndvr::SuppressHello() {
+  /* Trickle's redundancy constant: skip this Hello when k neighbors already
+   * announced our digest during the interval. Only while backed off (new
+   * neighbors must hear from us) and never twice in a row, so that the
+   * neighbors' hello timeout does not expire */
+  if (m_helloRedundancy == 0 || m_helloLastSuppressed)
+    return false;
+  if (m_helloIntervalCur < m_helloIntervalMax)
+    return false;
+  return m_helloConsistentHeard >= m_helloRedundancy;
+}
+
+void
+Ndvr::ScheduleHelloInterest() {
+  sendhello_event.cancel();
+  if (!m_enableAdaptiveHello) {
+    sendhello_event = m_scheduler.schedule(time::seconds(m_helloIntervalCur),
+                                          [this] { SendHelloInterest(); });
+    return;
+  }
+  /* as in Trickle, the Hello goes out at a random time in the second half of
+   * the current interval, so that neighbors reset at the same time do not
+   * send their Hellos together */
+  std::uniform_int_distribution<int> rand(500*m_helloIntervalCur, 1000*m_helloIntervalCur);
+  sendhello_event = m_scheduler.schedule(time::milliseconds(rand(m_rengine)),
                                         [this] { SendHelloInterest(); });
 }
 
+int
+Ndvr::MaxHelloGap() {
+  if (!m_enableAdaptiveHello)
+    return m_helloIntervalCur;
+  /* the next Hello goes out within the doubled interval and, once at the
+   * maximum, it may be suppressed (see SuppressHello) */
+  int gap = std::min(2*m_helloIntervalCur, m_helloIntervalMax);
+  if (m_helloRedundancy > 0 && gap == m_helloIntervalMax)
+    gap *= 2;
+  return gap;
+}
+
 void
-Ndvr::UpdateNeighHelloTimeout(NeighborEntry& neighbor) {
-  auto diff = neighbor.GetLastSeenDelta();
-  time::seconds timeout = time::seconds(3) + 2*std::max(time::seconds(m_helloIntervalIni), diff);
+Ndvr::UpdateNeighHelloTimeout(NeighborEntry& neighbor, uint32_t interval) {
+  /* the neighbor advertises the longest gap until its next Hello; without
+   * it, assume the maximum interval and a suppressed Hello. Tolerate one
+   * lost Hello */
+  if (interval == 0)
+    interval = 2*m_helloIntervalMax;
+  time::seconds timeout = time::seconds(3) + 2*time::seconds(interval);
   neighbor.SetHelloTimeout(timeout);
 }
 
 void
 Ndvr::RescheduleNeighRemoval(NeighborEntry& neighbor) {
-  neighbor.removal_event.cancel();
-  const std::string neigh_prefix = neighbor.GetName();
-  neighbor.removal_event = m_scheduler.schedule(neighbor.GetHelloTimeout(),
-                            [this, neigh_prefix] { RemoveNeighbor(neigh_prefix); });
+  /* there is no timer per neighbor: refreshing a neighbor only updates its
+   * last seen time, and a single sweep event removes the expired ones. The
+   * sweep only has to be moved when this neighbor expires before it */
   neighbor.UpdateLastSeen();
+  if (!neighsweep_event || neighbor.GetExpiry() < m_neighSweepTime)
+    ScheduleNeighSweep(neighbor.GetExpiry());
+}
+
+void
+Ndvr::ScheduleNeighSweep(time::steady_clock::TimePoint when) {
+  neighsweep_event.cancel();
+  m_neighSweepTime = when;
+  auto now = time::steady_clock::now();
+  auto delay = when > now ? time::duration_cast<time::nanoseconds>(when - now) : time::nanoseconds(0);
+  neighsweep_event = m_scheduler.schedule(delay, [this] { SweepNeighbors(); });
+}
+
+void
+Ndvr::SweepNeighbors() {
+  auto now = time::steady_clock::now();
+  std::vector<PrefixId> expired;
+  bool has_next = false;
+  time::steady_clock::TimePoint next;
+  for (auto& neigh : m_neighMap) {
+    auto expiry = neigh.second.GetExpiry();
+    if (expiry <= now) {
+      expired.push_back(neigh.first);
+    } else if (!has_next || expiry < next) {
+      next = expiry;
+      has_next = true;
+    }
+  }
+
+  for (PrefixId neigh : expired)
+    RemoveNeighbor(neigh);
+
+  /* next sweep at the earliest expiry among the remaining neighbors */
+  if (has_next)
+    ScheduleNeighSweep(next);
 }
 
 void
-Ndvr::RemoveNeighbor(const std::string neigh) {
-  NS_LOG_INFO("Remove neighbor=" << neigh);
+Ndvr::RemoveNeighbor(PrefixId neigh) {
+  NS_LOG_INFO("Remove neighbor=" << PrefixUri(neigh));
 
   auto neigh_it = m_neighMap.find(neigh);
   if (neigh_it == m_neighMap.end()) {
@@ -293,36 +439,105 @@ Ndvr::RemoveNeighbor(const std::string neigh) {
   }
 
   //bool need_adv = false;
+  uint64_t faceId = neigh_it->second.GetFaceId();
+  RoutingTable::Batch batch(m_routingTable);
+
+  /* cost changes on hold through this neighbor are gone as well */
+  for (auto it = m_settlingRoutes.begin(); it != m_settlingRoutes.end(); ) {
+    auto next = std::next(it);
+    DropSettlingNextHop(it->first, faceId);
+    it = next;
+  }
 
   // remove all routes whose next-hop is this neighbor (instead of remove, we increase the cost)
   for (auto it = m_routingTable.begin(); it != m_routingTable.end(); ++it) {
-    if (it->second.isNextHop(neigh_it->second.GetFaceId())) {
-      it->second.SetCost(neigh_it->second.GetFaceId(),
-          std::numeric_limits<uint32_t>::max());
-      it->second.IncSeqNum(1);
+    if (it->second.isNextHop(faceId)) {
+      /* alternative next hops left: fail over right away */
+      if (it->second.GetNextHops().size() > 1) {
+        RoutingEntry re = it->second;
+        m_routingTable.DeleteRoute(re, faceId);
+        continue;
+      }
+      it->second.SetCost(faceId, std::numeric_limits<uint32_t>::max());
+      m_routingTable.IncSeqNum(it->first, 1);
       //need_adv = true;
     }
     /* For local routes, increment the seqNum by 2 */
     if (it->second.isDirectRoute())
-      it->second.IncSeqNum(2);
+      m_routingTable.IncSeqNum(it->first, 2);
   }
+  ReleaseNeighborFace(faceId, neigh);
+
+  bool has_changed = batch.Commit();
+
+  // insert into recently removed
+  RememberNeighbor(neigh_it->second);
 
   // remove from neighbor map
   m_neighMap.erase(neigh);
-  m_pivot = m_neighMap.end();
+  m_neighRing.Erase(neigh);
 
-  // insert into recently removed
-  // TODO
+  /* routes learned through this neighbor are gone, other neighbors must
+   * send us their full DvInfo so that we can learn alternative routes */
+  ResetSyncedVersions();
+
+
+  /* neighbor loss: go back to the fast Hello interval and let the
+   * neighbors know about the new DvInfo right away */
+  ResetHelloInterval();
+  if (has_changed)
+    TriggerHello();
+}
+
+void
+Ndvr::RememberNeighbor(NeighborEntry& neighbor) {
+  auto now = time::steady_clock::now();
+  m_removedNeighbors[neighbor.GetPrefixId()] = {neighbor, now};
+
+  /* drop the expired ones and, if still too many, the oldest ones */
+  auto oldest = m_removedNeighbors.end();
+  for (auto it = m_removedNeighbors.begin(); it != m_removedNeighbors.end(); ) {
+    if (now - it->second.removedAt >= m_removedNeighborTtl) {
+      it = m_removedNeighbors.erase(it);
+      continue;
+    }
+    if (oldest == m_removedNeighbors.end() || it->second.removedAt < oldest->second.removedAt)
+      oldest = it;
+    ++it;
+  }
+  if (m_removedNeighbors.size() > m_removedNeighborsMax)
+    m_removedNeighbors.erase(oldest);
+}
 
-  //if (need_adv) {
-  //  /* schedule a immediate ehlo message to notify neighbors about a new DvInfo */
-  //  ResetHelloInterval();
-  //  SendHelloInterest();
-  //}
+bool
+Ndvr::RestoreNeighbor(NeighborEntry& neighbor) {
+  auto it = m_removedNeighbors.find(neighbor.GetPrefixId());
+  if (it == m_removedNeighbors.end())
+    return false;
+  bool expired = time::steady_clock::now() - it->second.removedAt >= m_removedNeighborTtl;
+  if (!expired) {
+    /* the announced version, RTT and link metric are back (its certificate
+     * is still in m_verifiedCerts). Not the synced version: our routes
+     * through it were advertised at infinity cost meanwhile, so the next
+     * DvInfo from it must be a full snapshot */
+    NS_LOG_INFO("Restore neighbor=" << PrefixUri(neighbor.GetPrefixId()) << " version=" << it->second.entry.GetVersion());
+    neighbor.SetVersion(it->second.entry.GetVersion());
+    neighbor.SetSyncedVersion(0);
+    neighbor.GetDvInfoRtt() = it->second.entry.GetDvInfoRtt();
+    neighbor.GetLinkMetric() = it->second.entry.GetLinkMetric();
+  }
+  m_removedNeighbors.erase(it);
+  return !expired;
+}
+
+void
+Ndvr::ResetSyncedVersions() {
+  for (auto& neigh : m_neighMap)
+    neigh.second.SetSyncedVersion(0);
 }
 
 void Ndvr::SchedDvInfoInterest(NeighborEntry& neighbor, bool wait, uint32_t retx) {
-  auto n = neighbor.GetName();
+  auto n = neighbor.GetPrefixId();
 
   /* is there any other DvInfo interest scheduled? if so, skip */
   auto n_event = dvinfointerest_event.find(n);
@@ -351,7 +566,7 @@ void Ndvr::SchedDvInfoInterest(NeighborEntry& neighbor, bool wait, uint32_t retx
     backoffTime = 750000;
   /* workaround to avoid wifi collisions */
   backoffTime += 10*m_rand->GetValue(0, 19999);
-  NS_LOG_INFO("SchedDvInfoInterest name=" << n << " wait=" << wait << " backoffTime=" << backoffTime);
+  NS_LOG_INFO("SchedDvInfoInterest name=" << PrefixUri(n) << " wait=" << wait << " backoffTime=" << backoffTime);
 
   dvinfointerest_event[n] = m_scheduler.schedule(
                                 time::microseconds(backoffTime),
@@ -359,7 +574,7 @@ void Ndvr::SchedDvInfoInterest(NeighborEntry& neighbor, bool wait, uint32_t retx
 }
 
 void
-Ndvr::SendDvInfoInterest(const std::string& neighbor_name, uint32_t retx) {
+Ndvr::SendDvInfoInterest(PrefixId neighbor_name, uint32_t retx) {
   /* cleanup scheduled event */
   dvinfointerest_event.erase(neighbor_name);
 
@@ -367,12 +582,46 @@ Ndvr::SendDvInfoInterest(const std::string& neighbor_name, uint32_t retx) {
   if (neigh_it == m_neighMap.end()) {
     return;
   }
-  auto neighbor = neigh_it->second;
+  auto& neighbor = neigh_it->second;
 
-  NS_LOG_INFO("Sending DV-Info Interest retx=" << retx << " to neighbor=" << neighbor_name);
+  NS_LOG_INFO("Sending DV-Info Interest retx=" << retx << " to neighbor=" << PrefixUri(neighbor_name));
   Name name = Name(kNdvrDvInfoPrefix);
-  name.append(neighbor_name);
+  name.append(m_routingTable.GetPrefixTable().GetName(neighbor_name));
   name.appendNumber(neighbor.GetVersion());
+  name.appendNumber(m_enableDeltaDvInfo ? neighbor.GetSyncedVersion() : 0);
+  name.appendSegment(0);
+
+  Interest interest = Interest();
+  interest.setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest.setName(name);
+  interest.setCanBePrefix(false);
+  interest.setMustBeFresh(true);
+  interest.setInterestLifetime(time::duration_cast<time::milliseconds>(neighbor.GetDvInfoRtt().getEstimatedRto()));
+
+  auto sentTime = time::steady_clock::now();
+  m_face.expressInterest(interest,
+    [this, neighbor_name, sentTime, retx] (const ndn::Interest& interest, const ndn::Data& data) {
+      auto neigh_it = m_neighMap.find(neighbor_name);
+      if (neigh_it != m_neighMap.end() && retx == 0) {
+        /* Karn's algorithm: only samples from Interests never retransmitted */
+        auto rtt = time::steady_clock::now() - sentTime;
+        neigh_it->second.GetDvInfoRtt().addMeasurement(rtt);
+        neigh_it->second.GetLinkMetric().OnRtt(rtt);
+        UpdateLinkCost(neigh_it->second);
+      } else if (retx > 0) {
+        m_dvinfoRecovered++;
+      }
+      OnDvInfoContent(interest, data);
+    },
+    std::bind(&Ndvr::OnDvInfoNack, this, _1, _2, retx),
+    std::bind(&Ndvr::OnDvInfoTimedOut, this, _1, retx));
+}
+
+void
+Ndvr::SendDvInfoSegmentInterest(const Name& prefix, uint64_t seg, uint32_t retx) {
+  Name name = prefix;
+  name.appendSegment(seg);
+  NS_LOG_INFO("Sending DV-Info segment Interest retx=" << retx << " name=" << name);
 
   Interest interest = Interest();
   interest.setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
@@ -381,10 +630,42 @@ Ndvr::SendDvInfoInterest(const std::string& neighbor_name, uint32_t retx) {
   interest.setMustBeFresh(true);
   interest.setInterestLifetime(time::seconds(m_localRTTimeout));
 
+  /* a Nack on a segment is handled as a timeout, otherwise the pipeline stalls */
   m_face.expressInterest(interest,
     std::bind(&Ndvr::OnDvInfoContent, this, _1, _2),
-    std::bind(&Ndvr::OnDvInfoNack, this, _1, _2),
-    std::bind(&Ndvr::OnDvInfoTimedOut, this, _1, retx));
+    std::bind(&Ndvr::OnDvInfoSegmentTimedOut, this, _1, retx),
+    std::bind(&Ndvr::OnDvInfoSegmentTimedOut, this, _1, retx));
+}
+
+void
+Ndvr::FillDvInfoPipeline(DvInfoFetch& fetch) {
+  while (fetch.inFlight < m_dvinfoSegmentWindow && fetch.nextSeg <= fetch.finalSeg) {
+    SendDvInfoSegmentInterest(fetch.prefix, fetch.nextSeg++);
+    fetch.inFlight++;
+  }
+}
+
+void Ndvr::OnDvInfoSegmentTimedOut(const ndn::Interest& interest, uint32_t retx) {
+  NS_LOG_DEBUG("Segment Interest timed out for Name: " << interest.getName() << " retx=" << retx);
+
+  PrefixId neighPrefix;
+  Name prefix = interest.getName().getPrefix(-1);
+  if (!m_routingTable.GetPrefixTable().Find(ExtractRouterPrefix(interest.getName(), kNdvrDvInfoPrefix), neighPrefix))
+    return;
+  auto fetch_it = m_dvinfoFetches.find(neighPrefix);
+  if (fetch_it == m_dvinfoFetches.end() || fetch_it->second.prefix != prefix) {
+    /* the fetch was already completed, abandoned or superseded */
+    return;
+  }
+
+  if (retx >= m_dvinfoSegmentMaxRetx) {
+    NS_LOG_INFO("Abandon DvInfo fetch prefix=" << prefix << " received=" << fetch_it->second.segments.size() << " finalSeg=" << fetch_it->second.finalSeg);
+    m_dvinfoFetches.erase(fetch_it);
+    return;
+  }
+
+  /* retransmit only the missing segment */
+  SendDvInfoSegmentInterest(prefix, interest.getName().get(-1).toSegment(), retx+1);
 }
 
 uint64_t Ndvr::ExtractIncomingFace(const ndn::Interest& interest) {
@@ -429,55 +710,63 @@ void Ndvr::processInterest(const ndn::Interest& interest) {
 }
 
 void Ndvr::IncreaseHelloInterval() {
-  /* exponetially increase the helloInterval until the maximum allowed */
-  if (increasehellointerval_event)
+  if (!m_enableAdaptiveHello)
     return;
-  increasehellointerval_event = m_scheduler.schedule(time::seconds(1),
-      [this] {
-        m_helloIntervalCur = (2*m_helloIntervalCur > m_helloIntervalMax) ? m_helloIntervalMax : 2*m_helloIntervalCur;
-      });
+  /* exponetially increase the helloInterval until the maximum allowed */
+  m_helloIntervalCur = (2*m_helloIntervalCur > m_helloIntervalMax) ? m_helloIntervalMax : 2*m_helloIntervalCur;
 }
 
 void Ndvr::ResetHelloInterval() {
-  increasehellointerval_event.cancel();
+  /* new neighbor, neighbor loss or local table change: if we were backing
+   * off, start over from the initial interval and reschedule the next Hello */
+  if (m_helloIntervalCur == m_helloIntervalIni)
+    return;
   m_helloIntervalCur = m_helloIntervalIni;
+  if (sendhello_event)
+    ScheduleHelloInterest();
 }
 
 void Ndvr::OnHelloInterest(const ndn::Interest& interest, uint64_t inFaceId) {
   const ndn::Name interestName(interest.getName());
   NS_LOG_INFO("Received HELLO Interest " << interestName);
 
-  std::string neighPrefix = ExtractRouterPrefix(interestName, kNdvrHelloPrefix);
   if (!isValidRouter(interestName, kNdvrHelloPrefix)) {
     NS_LOG_INFO("Not a router, ignoring...");
     return;
   }
-  if (neighPrefix == m_routerPrefix) {
+  std::string neighPrefixUri = ExtractRouterPrefix(interestName, kNdvrHelloPrefix);
+  if (neighPrefixUri == m_routerPrefixUri) {
     NS_LOG_INFO("Hello from myself, ignoring...");
     return;
   }
-
-  uint32_t numPrefixes = ExtractNumPrefixesFromAnnounce(interestName);
-  std::string digest = ExtractDigestFromAnnounce(interestName);
-  uint32_t version = ExtractVersionFromAnnounce(interestName);
-  std::vector<std::string> params;
-  if (interest.hasApplicationParameters() && interest.getApplicationParameters().value_size() > 0) {
-    std::string s;
-    s.assign((char *)interest.getApplicationParameters().value(), interest.getApplicationParameters().value_size());
-    NS_LOG_INFO("Neighbor=" << neighPrefix <<  " params=" << s);
-    boost::split(params, s, boost::is_any_of("&"));
+  proto::Hello hello;
+  if (!interest.hasApplicationParameters() ||
+      !hello.ParseFromArray(interest.getApplicationParameters().value(), interest.getApplicationParameters().value_size())) {
+    NS_LOG_INFO("Invalid Hello from " << neighPrefixUri << ", ignoring...");
+    return;
   }
+  /* only intern names of routers that sent a well-formed Hello */
+  PrefixId neighPrefix = m_routingTable.InternPrefix(neighPrefixUri);
+  uint32_t numPrefixes = hello.num_prefixes();
+  const std::string& digest = hello.digest();
+  if (digest == m_routingTable.GetDigest())
+    m_helloConsistentHeard++;
+  uint32_t version = hello.version();
+  NS_LOG_INFO("Neighbor=" << neighPrefixUri << " numPrefixes=" << numPrefixes << " version=" << version
+              << " digest=" << toHex(reinterpret_cast<const uint8_t*>(digest.data()), digest.size()));
   std::string neigh_mac;
-  if (m_enableUnicastFaces) {
-    neigh_mac = params.back();
-    params.pop_back();
+  if (m_enableUnicastFaces && hello.mac().size() == 6) {
+    ns3::Mac48Address addr;
+    addr.CopyFrom(reinterpret_cast<const uint8_t*>(hello.mac().data()));
+    neigh_mac = boost::lexical_cast<std::string>(addr);
     NS_LOG_INFO("Neighbor_mac == " << neigh_mac);
   }
 
   auto neigh = m_neighMap.find(neighPrefix);
   bool newNeigh = false;
+  bool restored = false;
   if (neigh == m_neighMap.end()) {
-    //ResetHelloInterval();
+    ResetHelloInterval();
     uint64_t neighFaceId = 0;
     if (m_enableUnicastFaces && !neigh_mac.empty()) {
       auto neighFaceId_it = m_neighToFaceId.find(neighPrefix);
@@ -492,37 +781,47 @@ void Ndvr::OnHelloInterest(const ndn::Interest& interest, uint64_t inFaceId) {
     }
     if (neighFaceId == 0)
       neighFaceId = inFaceId;
-    neigh = m_neighMap.emplace(neighPrefix, NeighborEntry(neighPrefix, neighFaceId, version)).first;
+    NeighborEntry entry(neighPrefix, neighFaceId, version);
+    restored = RestoreNeighbor(entry);
+    neigh = m_neighMap.emplace(neighPrefix, entry).first;
+    m_neighRing.Insert(neighPrefix);
     uint64_t oldFaceId = 0;
     registerNeighborPrefix(neigh->second, oldFaceId, neighFaceId);
     newNeigh = true;
+    /* get the neighbor's signing certificate before its first DvInfo */
+    if (m_signingMode == SigningMode::RSA || m_signingMode == SigningMode::ECDSA)
+      FetchNeighborCert(Name(neighPrefixUri).append("KEY"));
   } else {
-    NS_LOG_INFO("Already known router, increasing the hello interval");
+    NS_LOG_INFO("Already known router");
     if (neigh->second.GetFaceId() != inFaceId) {
       /* Issue #2: TODO: We need to be careful about this because since we are using default multicast forward strategy,
        * mean that one node can forward ndvr messages from other nodes, so the interest might be received from
        * the direct face or from the intermediate forwarder face! Not necessarily means the node moved! */
-      //NS_LOG_INFO("Neighbor moved from faceId=" << neigh->second.GetFaceId() << " to faceId=" << inFaceId << " neigh=" << neighPrefix);
+      //NS_LOG_INFO("Neighbor moved from faceId=" << neigh->second.GetFaceId() << " to faceId=" << inFaceId << " neigh=" << neighPrefixUri);
       //registerNeighborPrefix(neigh->second, neigh->second.GetFaceId(), inFaceId);
     }
-    //IncreaseHelloInterval();
     //return;
   }
-  UpdateNeighHelloTimeout(neigh->second);
+  UpdateNeighHelloTimeout(neigh->second, hello.interval());
   RescheduleNeighRemoval(neigh->second);
-  if (numPrefixes > 0 && (newNeigh || version > neigh->second.GetVersion()) && numPrefixes >= m_routingTable.size()) {
+  neigh->second.GetLinkMetric().OnHello(hello.seq());
+  if (!newNeigh)
+    UpdateLinkCost(neigh->second);
+  /* a neighbor restored from the recently removed cache only needs a
+   * DvInfo if its version moved while it was away */
+  if (numPrefixes > 0 && ((newNeigh && !restored) || version > neigh->second.GetVersion()) && numPrefixes >= m_routingTable.size()) {
     neigh->second.SetVersion(version);
 
     /* does we really have a change? */
-    if (digest != "0" && digest == m_routingTable.GetDigest()) {
-      NS_LOG_INFO("Same digest, so there was no change! digest=" << digest);
+    if (!digest.empty() && digest == m_routingTable.GetDigest()) {
+      NS_LOG_INFO("Same digest, so there was no change! version=" << version);
       return;
     }
 
     /* should we request immediatly or wait? */
     bool wait = true;
-    auto it = std::find(params.begin(), params.end(), m_routerPrefix);
-    if (it != params.end())
+    auto it = std::find(hello.neighbor().begin(), hello.neighbor().end(), m_routerPrefixUri);
+    if (it != hello.neighbor().end())
       wait = false;
     SchedDvInfoInterest(neigh->second, wait);
   } else {
@@ -535,33 +834,105 @@ void Ndvr::OnDvInfoInterest(const ndn::Interest& interest) {
 
   // Sanity check
   std::string routerPrefix = ExtractRouterPrefix(interest.getName(), kNdvrDvInfoPrefix);
-  if (routerPrefix != m_routerPrefix) {
+  if (routerPrefix != m_routerPrefixUri) {
     //NS_LOG_INFO("Interest is not to me, ignoring.. received_name=" << routerPrefix << " my_name=" << m_routerPrefix);
     return;
   }
+  if (!HasSegmentInDvInfo(interest.getName())) {
+    NS_LOG_INFO("DvInfo Interest without segment, ignoring...");
+    return;
+  }
+
+  /* remaining segments are served right away from the encoded reply */
+  uint64_t seg = interest.getName().get(-1).toSegment();
+  if (seg > 0) {
+    auto it = m_dvinfoReplies.find(interest.getName().getPrefix(-1));
+    if (it != m_dvinfoReplies.end() && !it->second.retired && seg < it->second.segments.size())
+      m_face.put(*it->second.segments[seg]);
+    return;
+  }
 
-  /* group DvInfo replies to avoid duplicates */
+  /* group DvInfo replies to avoid duplicates: requesters asking for the
+   * same name (version and base version) are served by a single reply */
+  m_pendingDvInfoInterests.emplace(interest.getName(), interest);
   if (replydvinfo_event)
     return;
   replydvinfo_event = m_scheduler.schedule(time::milliseconds(replydvinfo_dist(m_rengine)),
-      [this, interest] {
-        ReplyDvInfoInterest(interest);
+      [this] {
+        auto pending = std::move(m_pendingDvInfoInterests);
+        m_pendingDvInfoInterests.clear();
+        for (auto& it : pending)
+          ReplyDvInfoInterest(it.second);
       });
 }
 
 void Ndvr::ReplyDvInfoInterest(const ndn::Interest& interest) {
-  auto data = std::make_shared<ndn::Data>(interest.getName());
-  data->setFreshnessPeriod(ndn::time::milliseconds(1000));
+  Name prefix = interest.getName().getPrefix(-1);
+
+  /* a name is only ever bound to one encoding, otherwise the segments of
+   * an ongoing fetch (or those in the caches) would mix two encodings.
+   * The reply for this name was already signed: serve it as is, even if
+   * outdated, until it is retired (see ExpireDvInfoReplies) */
+  uint32_t version = m_routingTable.GetVersion();
+  Name signer = getSigningInfo().getSignerName();
+  ExpireDvInfoReplies(version, signer);
+  auto cached = m_dvinfoReplies.find(prefix);
+  if (cached != m_dvinfoReplies.end()) {
+    if (!cached->second.retired)
+      m_face.put(*cached->second.segments.front());
+    return;
+  }
+
   // Set dvinfo
   std::string dvinfo_str;
-  EncodeDvInfo(dvinfo_str);
-  NS_LOG_INFO("Replying DV-Info with encoded data: size=" << dvinfo_str.size() << " I=" << interest.getName());
+  EncodeDvInfo(dvinfo_str, ExtractBaseVersionFromDvInfo(prefix));
   //NS_LOG_INFO("Sending DV-Info encoded: str=" << dvinfo_str);
-  data->setContent(reinterpret_cast<const uint8_t*>(dvinfo_str.data()), dvinfo_str.size());
-  m_signedDataAmountDSK += dvinfo_str.size();
-  // Sign and send
-  m_keyChain.sign(*data, getSigningInfo());
-  m_face.put(*data);
+
+  /* split the encoded DvInfo into segments */
+  size_t segSize = std::max<size_t>(m_dvinfoSegmentSize, 1);
+  uint64_t lastSeg = dvinfo_str.empty() ? 0 : (dvinfo_str.size() - 1) / segSize;
+  NS_LOG_INFO("Replying DV-Info with encoded data: size=" << dvinfo_str.size() << " segments=" << lastSeg+1 << " I=" << interest.getName());
+
+  std::vector<std::shared_ptr<ndn::Data>> segments;
+  for (uint64_t seg = 0; seg <= lastSeg; seg++) {
+    size_t offset = seg*segSize;
+    size_t len = std::min(segSize, dvinfo_str.size() - offset);
+    auto data = std::make_shared<ndn::Data>(Name(prefix).appendSegment(seg));
+    data->setFreshnessPeriod(m_dvinfoReplyFreshness);
+    data->setFinalBlock(name::Component::fromSegment(lastSeg));
+    data->setContent(reinterpret_cast<const uint8_t*>(dvinfo_str.data()) + offset, len);
+    m_signedDataAmountDSK += len;
+    SignDvInfo(*data);
+    segments.push_back(data);
+  }
+
+  // Send the first segment, keep all of them while they are valid
+  m_face.put(*segments.front());
+  DvInfoReply& reply = m_dvinfoReplies[prefix];
+  reply.version = version;
+  reply.signer = signer;
+  reply.segments = std::move(segments);
+}
+
+void Ndvr::ExpireDvInfoReplies(uint32_t version, const Name& signer) {
+  for (auto& it : m_dvinfoReplies) {
+    DvInfoReply& reply = it.second;
+    if (reply.expiring || (reply.version == version && reply.signer == signer))
+      continue;
+    /* outdated, but requesters may still be fetching its segments: served
+     * for one more freshness period. Then it is kept for another one, not
+     * served, so that no fresh copy of its segments is left in the caches
+     * once the name gets a new encoding */
+    reply.expiring = true;
+    Name prefix = it.first;
+    m_scheduler.schedule(m_dvinfoReplyFreshness, [this, prefix] {
+      auto r = m_dvinfoReplies.find(prefix);
+      if (r == m_dvinfoReplies.end())
+        return;
+      r->second.retired = true;
+      m_scheduler.schedule(m_dvinfoReplyFreshness, [this, prefix] { m_dvinfoReplies.erase(prefix); });
+    });
+  }
 }
 
 void Ndvr::OnKeyInterest(const ndn::Interest& interest) {
@@ -572,7 +943,20 @@ void Ndvr::OnKeyInterest(const ndn::Interest& interest) {
 
   try {
     // Create Data packet
-    auto cert = m_keyChain.getPib().getIdentity(identityName).getKey(interest.getName()).getDefaultCertificate();
+    ndn::security::v2::Certificate cert;
+    if (interest.getName().get(-1) == name::Component("KEY")) {
+      /* <routerPrefix>/KEY: certificate currently used to sign DvInfo */
+      identityName = interest.getName().getPrefix(-1);
+      auto identity = m_keyChain.getPib().getIdentity(identityName);
+      if (m_enableDSK && m_signingInfoDSK.getSignerType() == ndn::security::SigningInfo::SIGNER_TYPE_CERT) {
+        const Name& certName = m_signingInfoDSK.getSignerName();
+        cert = identity.getKey(certName.getPrefix(-2)).getCertificate(certName);
+      } else {
+        cert = identity.getDefaultKey().getDefaultCertificate();
+      }
+    } else {
+      cert = m_keyChain.getPib().getIdentity(identityName).getKey(interest.getName()).getDefaultCertificate();
+    }
 
     // Return Data packet to the requester
     m_face.put(cert);
@@ -582,43 +966,117 @@ void Ndvr::OnKeyInterest(const ndn::Interest& interest) {
   }
 }
 
+bool Ndvr::VerifyWithCachedCert(const ndn::Data& data, const std::string& neighPrefix) {
+  if (!data.getSignature().hasKeyLocator())
+    return false;
+  /* same relation as in validation.conf: the key belongs to the router */
+  const Name& keyName = data.getSignature().getKeyLocator().getName();
+  if (keyName.size() < 2 || keyName.get(-2) != name::Component("KEY") || keyName.getPrefix(-2) != Name(neighPrefix))
+    return false;
+
+  auto it = m_verifiedCerts.find(keyName);
+  if (it == m_verifiedCerts.end()) {
+    /* new key (eg, DSK rotation): the validator fetches it this time and
+     * it is cached once validated (see ReleaseChainWalk) */
+    return false;
+  }
+  if (it->second.expiry <= time::system_clock::now()) {
+    m_verifiedCerts.erase(it);
+    return false;
+  }
+  return ndn::security::verifySignature(data, it->second.cert);
+}
+
+void Ndvr::FetchNeighborCert(const Name& keyName) {
+  NS_LOG_DEBUG("Fetching neighbor certificate " << keyName);
+  Interest interest(keyName);
+  interest.setCanBePrefix(true);
+  interest.setMustBeFresh(true);
+  interest.setInterestLifetime(time::seconds(m_localRTTimeout));
+  m_face.expressInterest(interest,
+    [this] (const Interest&, const Data& data) { OnNeighborCert(data); },
+    [](const Interest&, const lp::Nack&) {},
+    [](const Interest&) {});
+}
+
+void Ndvr::OnNeighborCert(const ndn::Data& data) {
+  /* validated through the regular trust schema before being cached */
+  m_validator.validate(data,
+    [this] (const ndn::Data& data) {
+      try {
+        ndn::security::v2::Certificate cert(data);
+        CacheNeighborCert(cert);
+        m_validator.cacheVerifiedCertificate(std::move(cert));
+      }
+      catch (const std::exception& e) {
+        NS_LOG_DEBUG("Invalid neighbor certificate " << data.getName() << ": " << e.what());
+      }
+    },
+    [] (const ndn::Data& data, const ndn::security::v2::ValidationError& ve) {
+      NS_LOG_DEBUG("Not validated neighbor certificate: " << data.getName() << ". The failure info: " << ve);
+    });
+}
+
+void Ndvr::CacheNeighborCert(const ndn::security::v2::Certificate& cert) {
+  auto notAfter = cert.getValidityPeriod().getPeriod().second;
+  auto expiry = std::min(notAfter, time::system_clock::now() + m_certCacheMaxTtl);
+  NS_LOG_DEBUG("Cached neighbor certificate " << cert.getName());
+  /* drop the expired ones (eg, rotated DSKs) */
+  for (auto it = m_verifiedCerts.begin(); it != m_verifiedCerts.end(); ) {
+    if (it->second.expiry <= time::system_clock::now())
+      it = m_verifiedCerts.erase(it);
+    else
+      ++it;
+  }
+  m_verifiedCerts[cert.getKeyName()] = {cert, expiry};
+}
+
 void Ndvr::OnDvInfoTimedOut(const ndn::Interest& interest, uint32_t retx) {
-  // TODO: Apply the same logic as in HelloProtocol::processInterestTimedOut (~/mini-ndn/ndn-src/NLSR/src/hello-protocol.cpp)
   // TODO: what if node has moved?
   NS_LOG_DEBUG("Interest timed out for Name: " << interest.getName()<< " retx=" << retx);
-  return;
-
-  /* what is the maximum retransmission? Just 1?*/
-  if (retx > 1)
-    return;
 
   /* Sanity checks */
-  std::string neighPrefix = ExtractRouterPrefix(interest.getName(), kNdvrDvInfoPrefix);
-  if (!isValidRouter(interest.getName(), kNdvrDvInfoPrefix) || neighPrefix == m_routerPrefix) {
+  PrefixId neighPrefix;
+  if (!isValidRouter(interest.getName(), kNdvrDvInfoPrefix) ||
+      !m_routingTable.GetPrefixTable().Find(ExtractRouterPrefix(interest.getName(), kNdvrDvInfoPrefix), neighPrefix)) {
     return;
   }
   auto neigh_it = m_neighMap.find(neighPrefix);
   if (neigh_it == m_neighMap.end()) {
     return;
   }
-  uint32_t version = ExtractVersionFromAnnounce(interest.getName());
+  uint32_t version = ExtractVersionFromDvInfo(interest.getName());
   if (version < neigh_it->second.GetVersion()) {
-    /* there is a newer version, so no sense retransmite this */
+    /* there is a newer version, so no sense retransmite this (the newer
+     * one was requested when it was announced) */
+    NS_LOG_INFO("Drop DvInfo retransmission, newer version announced=" << neigh_it->second.GetVersion() << " requested=" << version);
+    m_dvinfoStale++;
+    return;
+  }
+  if (retx >= m_dvinfoMaxRetx) {
+    NS_LOG_INFO("Abandon DvInfo fetch name=" << interest.getName() << " retx=" << retx);
+    m_dvinfoAbandoned++;
     return;
   }
 
-  /* is it worth to send a DvInfo now instead of waiting the next hello/dvinfo exchange cycle? */
-  // if (neigh_it->second.GetLastSeenDelta() >= m_helloIntervalCur -1)
-  //   return
-
-  SchedDvInfoInterest(neigh_it->second, retx+1);
+  /* retransmit right away (plus the usual jitter), with a doubled RTO */
+  neigh_it->second.GetDvInfoRtt().backoffRto();
+  SchedDvInfoInterest(neigh_it->second, false, retx+1);
 }
 
-void Ndvr::OnDvInfoNack(const ndn::Interest& interest, const ndn::lp::Nack& nack) {
+void Ndvr::OnDvInfoNack(const ndn::Interest& interest, const ndn::lp::Nack& nack, uint32_t retx) {
   NS_LOG_DEBUG("Received Nack with reason: " << nack.getReason());
-  // should we treat as a timeout? should the Nack represent no changes on neigh DvInfo?
-  //m_scheduler.schedule(ndn::time::seconds(m_localRTInterval),
-  //  [this, interest] { processInterestTimedOut(interest); });
+  /* the Nack comes before the Interest lifetime, so wait one RTO and then
+   * handle it as a timeout, otherwise retransmissions would follow each
+   * other while there is no route (or the link is congested) */
+  PrefixId neighPrefix;
+  if (!m_routingTable.GetPrefixTable().Find(ExtractRouterPrefix(interest.getName(), kNdvrDvInfoPrefix), neighPrefix))
+    return;
+  auto neigh_it = m_neighMap.find(neighPrefix);
+  if (neigh_it == m_neighMap.end())
+    return;
+  m_scheduler.schedule(neigh_it->second.GetDvInfoRtt().getEstimatedRto(),
+    [this, interest, retx] { OnDvInfoTimedOut(interest, retx); });
 }
 
 void Ndvr::OnDvInfoContent(const ndn::Interest& interest, const ndn::Data& data) {
@@ -630,7 +1088,7 @@ void Ndvr::OnDvInfoContent(const ndn::Interest& interest, const ndn::Data& data)
     NS_LOG_INFO("Not a router, ignoring...");
     return;
   }
-  if (neighPrefix == m_routerPrefix) {
+  if (neighPrefix == m_routerPrefixUri) {
     NS_LOG_INFO("DvInfo from myself, ignoring...");
     return;
   }
@@ -640,173 +1098,525 @@ void Ndvr::OnDvInfoContent(const ndn::Interest& interest, const ndn::Data& data)
     NS_LOG_DEBUG("Data signed with: " << data.getSignature().getKeyLocator().getName() << " type=" << data.getSignature().getType());
   }
 
+  PrefixId neighId;
+  if (!m_routingTable.GetPrefixTable().Find(neighPrefix, neighId)) {
+    NS_LOG_INFO("Discard DvInfo from unknonw neighbor=" << neighPrefix);
+    return;
+  }
+
+  /* queue it for verification: results are committed in arrival order
+   * for each neighbor (see CommitDvInfoVerifications) */
+  auto job = std::make_shared<DvInfoVerification>();
+  job->neighbor = neighId;
+  job->data = std::make_shared<ndn::Data>(data);
+  auto& queue = m_dvinfoVerifyQueues[neighId];
+
+  /* the keys belong to the neighbor, so the DvInfo still pending signed
+   * by the same key are in its queue */
+  Name keyName;
+  if (data.getSignature().hasKeyLocator())
+    keyName = data.getSignature().getKeyLocator().getName();
+  bool sameKeyPending = false;
+  for (const auto& other : queue) {
+    if (other->state == DvInfoVerification::PENDING && other->data->getSignature().hasKeyLocator() &&
+        other->data->getSignature().getKeyLocator().getName() == keyName) {
+      sameKeyPending = true;
+      break;
+    }
+  }
+  queue.push_back(job);
+  m_dvinfoVerifyBacklog.push_back(job);
+
+  /* a burst signed by the same key (eg, the segments of a reply) is
+   * collected for a short window and goes through the same certificate
+   * chain walk (see VerifyDvInfo); any other DvInfo starts right away */
+  if (!sameKeyPending)
+    StartDvInfoVerifications();
+  else if (!dvinfoverify_event)
+    dvinfoverify_event = m_scheduler.schedule(m_dvinfoVerifyBatchWindow,
+                                              [this] { StartDvInfoVerifications(); });
+}
 
-  // Validating data
-  m_validator.validate(data,
-                       std::bind(&Ndvr::OnValidatedDvInfo, this, _1),
-                       std::bind(&Ndvr::OnDvInfoValidationFailed, this, _1, _2));
+void Ndvr::StartDvInfoVerifications() {
+  /* verifications that complete right away call us back, the outer call
+   * takes care of the backlog */
+  if (m_dvinfoVerifyStarting)
+    return;
+  dvinfoverify_event.cancel();
+  m_dvinfoVerifyStarting = true;
+  while (m_dvinfoVerifyInFlight < m_dvinfoVerifyMaxInFlight && !m_dvinfoVerifyBacklog.empty()) {
+    auto job = m_dvinfoVerifyBacklog.front();
+    m_dvinfoVerifyBacklog.pop_front();
+    m_dvinfoVerifyInFlight++;
+    VerifyDvInfo(job);
+  }
+  m_dvinfoVerifyStarting = false;
+}
+
+void Ndvr::VerifyDvInfo(std::shared_ptr<DvInfoVerification> job) {
+  auto done = [this, job] (bool valid) {
+    job->state = valid ? DvInfoVerification::VALID : DvInfoVerification::INVALID;
+    m_dvinfoVerifyInFlight--;
+    CommitDvInfoVerifications(job->neighbor);
+    StartDvInfoVerifications();
+  };
+
+  /* runs as a separate event, so the verification does not delay the
+   * processing of the packet being handled (eg, Hellos) */
+  m_scheduler.schedule(time::milliseconds(0), [this, job, done] {
+    const ndn::Data& data = *job->data;
+    std::string reason;
+    switch (m_signingMode) {
+    case SigningMode::HMAC:
+      if (m_hmacSigner && m_hmacSigner->Verify(data))
+        return done(true);
+      reason = "HMAC mismatch";
+      break;
+    case SigningMode::DIGEST:
+      if (ndn::security::verifyDigest(data, DigestAlgorithm::SHA256))
+        return done(true);
+      reason = "digest mismatch";
+      break;
+    default:
+      if (VerifyWithCachedCert(data, PrefixUri(job->neighbor)))
+        return done(true);
+      std::function<void(bool)> finish = done;
+      if (data.getSignature().hasKeyLocator()) {
+        Name keyName = data.getSignature().getKeyLocator().getName();
+        auto walk = m_dvinfoChainWalks.find(keyName);
+        if (walk != m_dvinfoChainWalks.end()) {
+          /* the chain of this key is already being walked: wait for it
+           * and then verify against the certificate it fetched */
+          walk->second.push_back(job);
+          m_dvinfoVerifyInFlight--;
+          return StartDvInfoVerifications();
+        }
+        m_dvinfoChainWalks[keyName];
+        finish = [this, done, keyName] (bool valid) {
+          ReleaseChainWalk(keyName, valid);
+          done(valid);
+        };
+      }
+      m_validator.validate(data,
+                           [finish] (const ndn::Data&) { finish(true); },
+                           [this, finish] (const ndn::Data& data, const ndn::security::v2::ValidationError& ve) {
+                             OnDvInfoValidationFailed(data, ve);
+                             finish(false);
+                           });
+      return;
+    }
+    OnDvInfoValidationFailed(data, ndn::security::v2::ValidationError(
+          ndn::security::v2::ValidationError::INVALID_SIGNATURE, reason));
+    done(false);
+  });
+}
+
+void Ndvr::ReleaseChainWalk(const Name& keyName, bool valid) {
+  auto walk = m_dvinfoChainWalks.find(keyName);
+  if (walk == m_dvinfoChainWalks.end())
+    return;
+  auto waiting = std::move(walk->second);
+  m_dvinfoChainWalks.erase(walk);
+
+  /* the walk left the key's certificate in the validator's cache: keep it
+   * in ours too, for the next DvInfo and for the waiting ones */
+  const ndn::security::v2::Certificate* cert = nullptr;
+  if (valid) {
+    Interest certInterest(keyName);
+    certInterest.setCanBePrefix(true);
+    cert = m_validator.findTrustedCert(certInterest);
+    if (cert != nullptr)
+      CacheNeighborCert(*cert);
+  }
+  if (waiting.empty())
+    return;
+  if (cert == nullptr) {
+    /* back to the validator, the waiting ones go first keeping their
+     * relative order */
+    m_dvinfoVerifyBacklog.insert(m_dvinfoVerifyBacklog.begin(), waiting.begin(), waiting.end());
+    return;
+  }
+  std::set<PrefixId> neighbors;
+  for (auto& job : waiting) {
+    if (VerifyWithCachedCert(*job->data, PrefixUri(job->neighbor))) {
+      job->state = DvInfoVerification::VALID;
+    } else {
+      job->state = DvInfoVerification::INVALID;
+      OnDvInfoValidationFailed(*job->data, ndn::security::v2::ValidationError(
+            ndn::security::v2::ValidationError::INVALID_SIGNATURE, "signature mismatch"));
+    }
+    neighbors.insert(job->neighbor);
+  }
+  for (auto neighbor : neighbors)
+    CommitDvInfoVerifications(neighbor);
+}
+
+void Ndvr::CommitDvInfoVerifications(PrefixId neighbor) {
+  auto it = m_dvinfoVerifyQueues.find(neighbor);
+  if (it == m_dvinfoVerifyQueues.end())
+    return;
+  /* a DvInfo is only processed after the ones received before it */
+  auto& queue = it->second;
+  while (!queue.empty() && queue.front()->state != DvInfoVerification::PENDING) {
+    auto job = queue.front();
+    queue.pop_front();
+    if (job->state == DvInfoVerification::VALID)
+      OnValidatedDvInfo(*job->data);
+  }
+  if (queue.empty())
+    m_dvinfoVerifyQueues.erase(it);
 }
 
 void Ndvr::OnValidatedDvInfo(const ndn::Data& data) {
   NS_LOG_DEBUG("Validated data: " << data.getName());
-  std::string neighPrefix = ExtractRouterPrefix(data.getName(), kNdvrDvInfoPrefix);
+  std::string neighPrefixUri = ExtractRouterPrefix(data.getName(), kNdvrDvInfoPrefix);
 
   /* Sanity check: at this point the neighbor should be known */
-  auto neigh_it = m_neighMap.find(neighPrefix);
+  PrefixId neighPrefix;
+  NeighborMap::iterator neigh_it = m_neighMap.end();
+  if (m_routingTable.GetPrefixTable().Find(neighPrefixUri, neighPrefix))
+    neigh_it = m_neighMap.find(neighPrefix);
   if (neigh_it == m_neighMap.end()) {
-    NS_LOG_INFO("Discard DvInfo from unknonw neighbor=" << neighPrefix);
+    NS_LOG_INFO("Discard DvInfo from unknonw neighbor=" << neighPrefixUri);
     return;
   }
 
   /* Update lastSeen and reschedule neighbor removal */
   RescheduleNeighRemoval(neigh_it->second);
 
-  /* Extract DvInfo and process Distance Vector update */
+  const Name& name = data.getName();
+  if (!HasSegmentInDvInfo(name)) {
+    NS_LOG_INFO("DvInfo without segment, ignoring...");
+    return;
+  }
   const auto& content = data.getContent();
-  proto::DvInfo dvinfo_proto;
-  //NS_LOG_DEBUG("Content: size=" << content.value_size());
-  //NS_LOG_INFO("Trying to parser  DV-Info...");
-  if (!dvinfo_proto.ParseFromArray(content.value(), content.value_size())) {
+  uint64_t seg = name.get(-1).toSegment();
+  uint64_t finalSeg = data.getFinalBlock() ? data.getFinalBlock()->toSegment() : seg;
+  if (seg == 0 && finalSeg == 0) {
+    ProcessDvInfo(neigh_it->second, content.value(), content.value_size());
+    return;
+  }
+
+  /* Segmented DvInfo: reassemble all segments before processing */
+  Name prefix = name.getPrefix(-1);
+  auto fetch_it = m_dvinfoFetches.find(neighPrefix);
+  if (seg == 0) {
+    if (fetch_it == m_dvinfoFetches.end() || fetch_it->second.prefix != prefix) {
+      DvInfoFetch fetch;
+      fetch.prefix = prefix;
+      fetch.finalSeg = finalSeg;
+      m_dvinfoFetches[neighPrefix] = fetch;
+      fetch_it = m_dvinfoFetches.find(neighPrefix);
+    }
+  } else {
+    if (fetch_it == m_dvinfoFetches.end() || fetch_it->second.prefix != prefix) {
+      NS_LOG_DEBUG("Discard segment from a superseded DvInfo fetch " << name);
+      return;
+    }
+    if (fetch_it->second.inFlight > 0)
+      fetch_it->second.inFlight--;
+  }
+  auto& fetch = fetch_it->second;
+  if (seg > fetch.finalSeg)
+    return;
+  fetch.segments[seg].assign(reinterpret_cast<const char*>(content.value()), content.value_size());
+
+  if (fetch.segments.size() <= fetch.finalSeg) {
+    FillDvInfoPipeline(fetch);
+    return;
+  }
+
+  std::string dvinfo_str;
+  for (const auto& it : fetch.segments)
+    dvinfo_str.append(it.second);
+  m_dvinfoFetches.erase(fetch_it);
+  ProcessDvInfo(neigh_it->second, reinterpret_cast<const uint8_t*>(dvinfo_str.data()), dvinfo_str.size());
+}
+
+void Ndvr::ProcessDvInfo(NeighborEntry& neighbor, const uint8_t* buf, size_t buf_size) {
+  /* Extract DvInfo and process Distance Vector update. The first pass only
+   * checks the encoding, so that an invalid DvInfo is not partially applied */
+  uint64_t version, base_version;
+  uint32_t num_entries = 0;
+  //NS_LOG_DEBUG("Content: size=" << buf_size);
+  if (!ForEachDvInfoEntry(buf, buf_size, version, base_version,
+                          [&num_entries] (const DvInfoEntryView&) { num_entries++; })) {
     NS_LOG_INFO("Invalid DvInfo content!!! Abort processing..");
     return;
   }
-  //NS_LOG_INFO("Parser complete! dvinfo_proto content is:");
-  //for (int i = 0; i < dvinfo_proto.entry_size(); ++i) {
-  //  const auto& entry = dvinfo_proto.entry(i);
-  //  NS_LOG_INFO("DV-Info from neighbor prefix=" << entry.prefix() << " seqNum=" << entry.seq() << " cost=" << entry.cost());
-  //}
-  //NS_LOG_INFO("Decoding...");
-  auto otherRT = DecodeDvInfo(dvinfo_proto);
-  processDvInfoFromNeighbor(neigh_it->second, otherRT);
-  //NS_LOG_INFO("Done");
+  NS_LOG_DEBUG("DvInfo version=" << version << " base_version=" << base_version << " entries=" << num_entries);
+  processDvInfoFromNeighbor(neighbor, buf, buf_size);
+  /* a delta only brings us up to date if we did not drop our synced
+   * version meanwhile (see ResetSyncedVersions) */
+  if (base_version == 0 || neighbor.GetSyncedVersion() != 0)
+    neighbor.SetSyncedVersion(version);
 }
 
 void Ndvr::OnDvInfoValidationFailed(const ndn::Data& data, const ndn::security::v2::ValidationError& ve) {
   NS_LOG_DEBUG("Not validated data: " << data.getName() << ". The failure info: " << ve);
 }
 
-void Ndvr::UpdateRoutingTableDigest() {
-  proto::DvInfo to_calc_digest;
-  std::string str_digest;
-  for (auto it = m_routingTable.begin(); it != m_routingTable.end(); ++it) {
-    auto* e2 = to_calc_digest.add_entry();
-    e2->set_prefix(it->first);
-    e2->set_seq(it->second.GetSeqNum());
-    e2->set_cost(0);
-  }
-  to_calc_digest.AppendToString(&str_digest);
-  boost::uuids::detail::sha1 sha1;
-  unsigned int hash[5];
-  sha1.process_bytes(str_digest.c_str(), str_digest.size());
-  sha1.get_digest(hash);
-  std::stringstream stream;
-  for(std::size_t i=0; i<sizeof(hash)/sizeof(hash[0]); ++i) {
-      stream << std::hex << hash[i];
-  }
-  std::string res = stream.str();
-  NS_LOG_DEBUG("RoutingTable_digest: " << res);
-  m_routingTable.SetDigest(res);
-}
-
-void Ndvr::EncodeDvInfo(std::string& out) {
+void Ndvr::EncodeDvInfo(std::string& out, uint32_t baseVersion) {
   proto::DvInfo dvinfo_proto;
-  for (auto it = m_routingTable.begin(); it != m_routingTable.end(); ++it) {
-    auto* entry = dvinfo_proto.add_entry();
-    entry->set_prefix(it->first);
-    entry->set_seq(it->second.GetSeqNum());
-    entry->set_cost(it->second.GetCost());
+  std::vector<PrefixId> changes;
+  if (baseVersion != 0 && m_routingTable.GetChangesSince(baseVersion, changes)) {
+    /* delta DvInfo: only entries changed since baseVersion */
+    dvinfo_proto.set_base_version(baseVersion);
+    for (PrefixId id : changes) {
+      RoutingEntry re;
+      if (!m_routingTable.LookupRoute(id, re))
+        continue;
+      auto* entry = dvinfo_proto.add_entry();
+      entry->set_prefix(PrefixUri(id));
+      entry->set_seq(re.GetSeqNum());
+      entry->set_cost(re.GetCost());
+    }
+  } else {
+    for (auto it = m_routingTable.begin(); it != m_routingTable.end(); ++it) {
+      auto* entry = dvinfo_proto.add_entry();
+      entry->set_prefix(PrefixUri(it->first));
+      entry->set_seq(it->second.GetSeqNum());
+      entry->set_cost(it->second.GetCost());
+    }
   }
+  dvinfo_proto.set_version(m_routingTable.GetVersion());
   dvinfo_proto.AppendToString(&out);
 }
 
 void
-Ndvr::processDvInfoFromNeighbor(NeighborEntry& neighbor, RoutingTable& otherRT) {
-  NS_LOG_INFO("Process DvInfo from neighbor=" << neighbor.GetName());
-  bool has_changed = false;
-
-  for (auto entry : otherRT) {
-    std::string neigh_prefix = entry.first;
-    uint64_t neigh_seq = entry.second.GetSeqNum();
-    uint32_t neigh_cost = entry.second.GetCost();
-    NS_LOG_INFO("===>> prefix=" << neigh_prefix << " seqNum=" << neigh_seq << " recvCost=" << neigh_cost);
-
-    /* Sanity checks: 1) ignore our own name prefixes (direct route); 2) ignore invalid seqNum; 3) ignore invalid Cost */
-    if (m_routingTable.isDirectRoute(neigh_prefix) || neigh_seq <= 0 || !isValidCost(neigh_cost))
-      continue;
-
-    /* insert new prefix */
-    RoutingEntry localRE;
-    if (!m_routingTable.LookupRoute(neigh_prefix, localRE)) {
-      NS_LOG_INFO("======>> New prefix! Just insert it " << neigh_prefix);
-      entry.second.SetCost(CalculateCostToNeigh(neighbor, neigh_cost));
-      entry.second.SetFaceId(neighbor.GetFaceId());
-      m_routingTable.AddRoute(entry.second);
+Ndvr::processDvInfoFromNeighbor(NeighborEntry& neighbor, const uint8_t* buf, size_t buf_size) {
+  NS_LOG_INFO("Process DvInfo from neighbor=" << PrefixUri(neighbor.GetPrefixId()));
+  /* apply the whole DvInfo at once: single version bump and FIB update */
+  RoutingTable::Batch batch(m_routingTable);
+
+  /* entries are fed straight from the wire buffer, no intermediate table;
+   * prefixes are handled by id once accepted (see processDvInfoEntry) */
+  uint64_t version, base_version;
+  ForEachDvInfoEntry(buf, buf_size, version, base_version,
+    [this, &neighbor] (const DvInfoEntryView& entry) {
+      if (entry.prefix_size == 0)
+        return;
+      processDvInfoEntry(neighbor, std::string(entry.prefix, entry.prefix_size), entry.seq, entry.cost);
+    });
+
+  /* any change counts, seqNum-only ones included */
+  if (batch.Commit()) {
+    /* schedule a immediate ehlo message to notify neighbors about a new DvInfo */
+    ResetHelloInterval();
+    TriggerHello();
+  }
+}
 
-      has_changed = true;
-      continue;
+bool
+Ndvr::processDvInfoEntry(NeighborEntry& neighbor, const std::string& neigh_uri, uint64_t neigh_seq, uint32_t neigh_cost) {
+  NS_LOG_INFO("===>> prefix=" << neigh_uri << " seqNum=" << neigh_seq << " recvCost=" << neigh_cost);
+
+  /* the prefix table never releases ids: look the prefix up without
+   * interning it, that only happens once the entry is accepted */
+  PrefixId neigh_prefix;
+  bool interned = m_routingTable.GetPrefixTable().Find(neigh_uri, neigh_prefix);
+
+  /* Sanity checks: 1) ignore our own name prefixes (direct route); 2) ignore invalid seqNum; 3) ignore invalid Cost */
+  if ((interned && m_routingTable.isDirectRoute(neigh_prefix)) || neigh_seq <= 0 || !isValidCost(neigh_cost))
+    return false;
+
+  /* insert new prefix */
+  RoutingEntry localRE;
+  if (!interned || !m_routingTable.LookupRoute(neigh_prefix, localRE)) {
+    NS_LOG_INFO("======>> New prefix! Just insert it " << neigh_uri);
+    if (!interned)
+      neigh_prefix = m_routingTable.InternPrefix(neigh_uri);
+    auto settling = m_settlingRoutes.find(neigh_prefix);
+    if (settling != m_settlingRoutes.end()) {
+      settling->second.event.cancel();
+      m_settlingRoutes.erase(settling);
     }
+    RoutingEntry newRE(neigh_prefix, neigh_seq, CalculateCostToNeigh(neighbor, neigh_cost), neighbor.GetFaceId());
+    SampleSettlingTime(neigh_prefix, neigh_seq, newRE.GetCost());
+    m_routingTable.AddRoute(newRE);
+    return true;
+  }
 
-    /* cost is "infinity", so remove it */
-    if (isInfinityCost(neigh_cost)) {
-      /* Delete route only if update was received from my nexthop neighbor */
-      if (!localRE.isNextHop(neighbor.GetFaceId()))
-        continue;
+  /* cost is "infinity", so remove it */
+  uint64_t faceId = neighbor.GetFaceId();
+  if (isInfinityCost(neigh_cost)) {
+    /* bad news are not held: the settling update must not bring it back */
+    DropSettlingNextHop(neigh_prefix, faceId);
+    /* Delete route only if update was received from one of my nexthop neighbors */
+    if (!localRE.isNextHop(faceId))
+      return false;
+
+    NS_LOG_INFO("======>> Infinity cost! Remove name prefix" << PrefixUri(neigh_prefix) << " faceId=" << faceId);
+    if (m_routingTable.DeleteRoute(localRE, faceId)) {
+      NS_LOG_INFO("======>> Fail over to faceId=" << localRE.GetFaceId() << " cost=" << localRE.GetCost());
+      return true;
+    }
+    /* other neighbors may still have a route for it, but they will only
+     * resend it in a full DvInfo */
+    ResetSyncedVersions();
+    return true;
+  }
 
-      NS_LOG_INFO("======>> Infinity cost! Remove name prefix" << neigh_prefix);
-      m_routingTable.DeleteRoute(localRE, neighbor.GetFaceId());
+  /* a cost change on hold (see SettleRoute) is the most recent local
+   * state: further updates are aggregated on it */
+  RoutingEntry installedRE = localRE;
+  auto settling = m_settlingRoutes.find(neigh_prefix);
+  if (settling != m_settlingRoutes.end())
+    localRE = settling->second.entry;
+
+  /* compare the Received and Local SeqNum (in Routing Entry)*/
+  uint32_t recv_cost = neigh_cost;
+  uint32_t local_cost = localRE.GetCost();
+  neigh_cost = CalculateCostToNeigh(neighbor, neigh_cost);
+  if (neigh_seq > localRE.GetSeqNum()) {
+    NS_LOG_INFO("======>> New SeqNum, update name prefix! local_seqNum=" << localRE.GetSeqNum() << " neigh_seqNum=" << neigh_seq << " local_cost=" << local_cost << " neigh_cost=" << neigh_cost);
+    /* next hops learned with an older seqNum are not viable anymore */
+    localRE.SetSeqNum(neigh_seq);
+    localRE.SetNextHop(faceId, neigh_cost, neigh_seq);
+    localRE.RemoveStaleNextHops();
+    return SettleRoute(localRE, installedRE);
+  } else if (neigh_seq == localRE.GetSeqNum()) {
+    /* Feasibility condition for multipath: an alternative next hop must be
+     * closer to the destination than we are, so it never routes through us */
+    if (localRE.GetFaceId() != faceId && recv_cost >= local_cost) {
+      if (localRE.isNextHop(faceId)) {
+        NS_LOG_INFO("======>> Next hop is not feasible anymore, remove it faceId=" << faceId);
+        DropSettlingNextHop(neigh_prefix, faceId);
+        if (installedRE.isNextHop(faceId))
+          m_routingTable.DeleteRoute(installedRE, faceId);
+      }
+      return false;
+    }
+    auto nh = localRE.GetNextHops().find(faceId);
+    if (nh != localRE.GetNextHops().end() && nh->second.cost == neigh_cost)
+      return false;
+    NS_LOG_INFO("======>> Equal SeqNum, update next hop faceId=" << faceId << " cost=" << neigh_cost << " local_cost=" << local_cost);
+    localRE.SetNextHop(faceId, neigh_cost, neigh_seq);
+    return SettleRoute(localRE, installedRE);
+  }
+  /* Recv_SeqNum < Local_SeqNu: discard/next, we already have a most recent update */
+  return false;
+}
 
-      has_changed = true;
-      continue;
+bool
+Ndvr::SettleRoute(RoutingEntry& re, RoutingEntry& installed) {
+  /* DSDV-like settling time: a cost change is held for a while, so that the
+   * best route of a new seqNum (which usually arrives after the first one)
+   * and further changes are aggregated, and only the settled best reaches
+   * the FIB. Updates which do not change the best next hop go right away */
+  PrefixId prefix = re.GetPrefixId();
+  SampleSettlingTime(prefix, re.GetSeqNum(), re.GetCost());
+  time::nanoseconds delay = SettlingDelay(prefix);
+  auto it = m_settlingRoutes.find(prefix);
+  if (delay <= time::nanoseconds::zero() ||
+      (re.GetFaceId() == installed.GetFaceId() && re.GetCost() == installed.GetCost())) {
+    if (it != m_settlingRoutes.end()) {
+      it->second.event.cancel();
+      m_settlingRoutes.erase(it);
     }
+    m_routingTable.UpdateRoute(re);
+    return re.GetCost() != installed.GetCost();
+  }
 
-    /* compare the Received and Local SeqNum (in Routing Entry)*/
-    neigh_cost = CalculateCostToNeigh(neighbor, neigh_cost);
-    if (neigh_seq > localRE.GetSeqNum()) {
-      // TODO:
-      //   - Recv_Cost == Local_cost: update Local_SeqNum
-      //   - Recv_Cost != Local_cost: wait SettlingTime, then update Local_Cost / Local_SeqNum
-      if (localRE.GetCost() == neigh_cost) {
-        NS_LOG_INFO("======>> New SeqNum same cost, update name prefix! local_seqNum=" << localRE.GetSeqNum() << " neigh_seqNum=" << neigh_seq);
-        if (!localRE.isNextHop(neighbor.GetFaceId())) {
-          /* TODO: if they have the same cost but from different faces, could save for multipath */
-        }
-        localRE.SetSeqNum(neigh_seq);
-      } else {
-        NS_LOG_INFO("======>> New SeqNum diff cost, update name prefix! local_seqNum=" << localRE.GetSeqNum() << " neigh_seqNum=" << neigh_seq << " local_cost=" << localRE.GetCost() << " neigh_cost=" << neigh_cost);
-        /* Cost change will be handle by periodic updates */
-        localRE.SetCost(neigh_cost);
-        localRE.SetSeqNum(neigh_seq);
-        m_routingTable.UpdateRoute(localRE, neighbor.GetFaceId());
-        has_changed = true;
-      }
-    } else if (neigh_seq == localRE.GetSeqNum() && neigh_cost < localRE.GetCost()) {
-      NS_LOG_INFO("======>> Equal SeqNum but Better Cost, update name prefix! local_cost=" << localRE.GetCost());
-      /* Cost change will be handle by periodic updates */
-      // TODO: wait SettlingTime, then update Local_Cost
-      localRE.SetCost(neigh_cost);
-      m_routingTable.UpdateRoute(localRE, neighbor.GetFaceId());
-      has_changed = true;
-    } else if (neigh_seq == localRE.GetSeqNum() && neigh_cost >= localRE.GetCost()) {
-      //NS_LOG_INFO("======>> Equal SeqNum and (Equal or Worst Cost), however learn name prefix! local_cost=" << localRE.GetCost());
-      // TODO: save this new prefix as well to multipath
-    } else {
-      /* Recv_SeqNum < Local_SeqNu: discard/next, we already have a most recent update */
-      continue;
+  if (it == m_settlingRoutes.end()) {
+    it = m_settlingRoutes.emplace(prefix, SettlingRoute()).first;
+    it->second.event = m_scheduler.schedule(delay, [this, prefix] { CommitSettledRoute(prefix); });
+  }
+  NS_LOG_INFO("======>> Settling prefix=" << PrefixUri(prefix) << " faceId=" << re.GetFaceId() << " cost=" << re.GetCost() << " delay=" << delay);
+  it->second.entry = re;
+  return false;
+}
+
+void
+Ndvr::SampleSettlingTime(PrefixId prefix, uint64_t seqNum, uint32_t cost) {
+  if (m_maxSettlingTime <= time::milliseconds::zero())
+    return;
+  /* as in DSDV, the settling time of a seqNum is the time between its first
+   * and its best update, whether the updates were held or not. It goes into
+   * the weighted average when the next seqNum arrives */
+  auto now = time::steady_clock::now();
+  auto it = m_settlingStats.find(prefix);
+  if (it == m_settlingStats.end()) {
+    /* seeded so that the first delay is the maximum */
+    it = m_settlingStats.emplace(prefix, SettlingStats()).first;
+    it->second.avg = m_maxSettlingTime / 2;
+  } else if (seqNum > it->second.seqNum) {
+    time::nanoseconds sample = it->second.bestArrival - it->second.firstArrival;
+    it->second.avg = (7*it->second.avg + sample) / 8;
+  } else {
+    if (seqNum == it->second.seqNum && cost < it->second.bestCost) {
+      it->second.bestCost = cost;
+      it->second.bestArrival = now;
     }
+    return;
   }
+  it->second.seqNum = seqNum;
+  it->second.bestCost = cost;
+  it->second.firstArrival = it->second.bestArrival = now;
+}
 
-  if (has_changed) {
-    m_routingTable.IncVersion();
-    //UpdateRoutingTableDigest();
-    /* schedule a immediate ehlo message to notify neighbors about a new DvInfo */
-    //ResetHelloInterval();
-    //SendHelloInterest();
+time::nanoseconds
+Ndvr::SettlingDelay(PrefixId prefix) {
+  if (m_maxSettlingTime <= time::milliseconds::zero())
+    return time::nanoseconds::zero();
+  /* twice the weighted settling time, bounded by the maximum; the floor
+   * keeps a few quiet seqNums from turning the settling off */
+  time::nanoseconds delay = m_maxSettlingTime;
+  auto stats = m_settlingStats.find(prefix);
+  if (stats != m_settlingStats.end())
+    delay = std::min<time::nanoseconds>(2*stats->second.avg, delay);
+  return std::max<time::nanoseconds>(delay, m_maxSettlingTime / 8);
+}
+
+void
+Ndvr::CommitSettledRoute(PrefixId prefix) {
+  auto it = m_settlingRoutes.find(prefix);
+  if (it == m_settlingRoutes.end())
+    return;
+
+  RoutingEntry re = it->second.entry;
+  m_settlingRoutes.erase(it);
+  NS_LOG_INFO("Settled prefix=" << PrefixUri(prefix) << " faceId=" << re.GetFaceId() << " cost=" << re.GetCost());
+
+  RoutingTable::Batch batch(m_routingTable);
+  m_routingTable.UpdateRoute(re);
+  if (batch.Commit()) {
+    ResetHelloInterval();
+    TriggerHello();
+  }
+}
+
+void
+Ndvr::DropSettlingNextHop(PrefixId prefix, uint64_t faceId) {
+  auto it = m_settlingRoutes.find(prefix);
+  if (it == m_settlingRoutes.end() || !it->second.entry.isNextHop(faceId))
+    return;
+  if (!it->second.entry.RemoveNextHop(faceId)) {
+    it->second.event.cancel();
+    m_settlingRoutes.erase(it);
   }
 }
 
 uint32_t
 Ndvr::CalculateCostToNeigh(NeighborEntry& neighbor, uint32_t cost) {
-  return cost+1;
+  if (!m_enableLinkMetric)
+    return cost+1;
+  /* saturate below infinity */
+  uint64_t total = uint64_t(cost) + neighbor.GetLinkMetric().GetCost();
+  return std::min<uint64_t>(total, std::numeric_limits<uint32_t>::max() - 1);
+}
+
+void
+Ndvr::UpdateLinkCost(NeighborEntry& neighbor) {
+  if (!m_enableLinkMetric || !neighbor.GetLinkMetric().UpdateCost(m_linkRttRef, m_linkCostHysteresis))
+    return;
+  NS_LOG_INFO("Link cost to neighbor=" << PrefixUri(neighbor.GetPrefixId()) << " changed to " << neighbor.GetLinkMetric().GetCost()
+              << " deliveryRatio=" << neighbor.GetLinkMetric().GetDeliveryRatio());
+  registerNeighborPrefix(neighbor, 0, neighbor.GetFaceId());
+  /* routes through this neighbor are recomputed from a full DvInfo (equal
+   * seqNum entries update the cost of the next hop) */
+  neighbor.SetSyncedVersion(0);
+  SchedDvInfoInterest(neighbor);
 }
 
 bool
@@ -821,7 +1631,7 @@ Ndvr::isInfinityCost(uint32_t cost) {
 
 void Ndvr::AdvNamePrefix(std::string name) {
   RoutingEntry routingEntry;
-  routingEntry.SetName(name);
+  routingEntry.SetPrefixId(m_routingTable.InternPrefix(name));
   routingEntry.SetSeqNum(1);
   routingEntry.SetCost(0);
   routingEntry.SetFaceId(0); /* directly connected */
@@ -831,12 +1641,12 @@ void Ndvr::AdvNamePrefix(std::string name) {
    * neighbors about a new DvInfo; otherwise, just insert on the initial
    * routing table
    * */
+  RoutingTable::Batch batch(m_routingTable);
   m_routingTable.insert(routingEntry);
-  m_routingTable.IncVersion();
-  //if (sendhello_event) {
-  //  ResetHelloInterval();
-  //  SendHelloInterest();
-  //}
+  if (batch.Commit()) {
+    ResetHelloInterval();
+    TriggerHello();
+  }
 }
 
 uint64_t Ndvr::CreateUnicastFace(std::string mac) {
@@ -5,6 +5,7 @@
 
 
 #include <iostream>
+#include <deque>
 #include <map>
 #include <unordered_map>
 #include <string>
@@ -15,14 +16,18 @@
 #include <ndn-cxx/security/key-chain.hpp>
 #include <ndn-cxx/security/signing-helpers.hpp>
 #include <ndn-cxx/security/validator-config.hpp>
+#include <ndn-cxx/util/rtt-estimator.hpp>
 #include <ndn-cxx/util/scheduler.hpp>
 #include <ndn-cxx/util/time.hpp>
 #include <ns3/core-module.h>
 #include <ns3/random-variable-stream.h>
 
 #include "routing-table.hpp"
+#include "neighbor-ring.hpp"
+#include "link-metric.hpp"
 #include "ndvr-message.pb.h"
 #include "ndvr-message-helper.hpp"
+#include "ndvr-signing.hpp"
 
 namespace ndn {
 namespace ndvr {
@@ -39,8 +44,8 @@ public:
   {
   }
 
-  NeighborEntry(std::string name, uint64_t faceId, uint64_t ver)
-    : m_name(name)
+  NeighborEntry(PrefixId prefixId, uint64_t faceId, uint64_t ver)
+    : m_prefixId(prefixId)
     , m_faceId(faceId)
     , m_version(ver)
     , m_lastSeen(time::steady_clock::now())
@@ -51,11 +56,11 @@ public:
   {
   }
 
-  void SetName(std::string name) {
-    m_name = name;
+  void SetPrefixId(PrefixId prefixId) {
+    m_prefixId = prefixId;
   }
-  std::string GetName() {
-    return m_name;
+  PrefixId GetPrefixId() {
+    return m_prefixId;
   }
 
   void SetVersion(uint64_t ver) {
@@ -65,6 +70,15 @@ public:
     return m_version;
   }
 
+  /* version of the last DvInfo processed from this neighbor (0 if none
+   * or if we need a full snapshot next time) */
+  void SetSyncedVersion(uint64_t ver) {
+    m_syncedVersion = ver;
+  }
+  uint64_t GetSyncedVersion() {
+    return m_syncedVersion;
+  }
+
   void SetFaceId(uint64_t faceId) {
     m_faceId = faceId;
   }
@@ -83,14 +97,25 @@ public:
   time::seconds GetHelloTimeout() {
     return m_helloTimeout;;
   }
-public:
-  scheduler::EventId removal_event;
+  time::steady_clock::TimePoint GetExpiry() {
+    return m_lastSeen + m_helloTimeout;
+  }
+  /* RTT/RTO of the DvInfo Interests sent to this neighbor */
+  util::RttEstimator& GetDvInfoRtt() {
+    return m_dvinfoRtt;
+  }
+  LinkMetric& GetLinkMetric() {
+    return m_linkMetric;
+  }
 private:
-  std::string m_name;
+  PrefixId m_prefixId;
   uint64_t m_faceId;
   uint64_t m_version;
+  uint64_t m_syncedVersion = 0;
   time::steady_clock::TimePoint m_lastSeen;
-  time::seconds m_helloTimeout;
+  time::seconds m_helloTimeout = time::seconds(0);
+  util::RttEstimator m_dvinfoRtt;
+  LinkMetric m_linkMetric;
   //TODO: key  
 };
 
@@ -121,6 +146,117 @@ public:
     m_enableUnicastFaces = flag;
   }
 
+  void EnableDeltaDvInfo(bool flag) {
+    m_enableDeltaDvInfo = flag;
+  }
+
+  void SetDvInfoSegmentSize(uint32_t x) {
+    m_dvinfoSegmentSize = x;
+  }
+
+  /* how routes are installed in the FIB: "management" or "direct" */
+  void SetFibBackend(const std::string& type) {
+    auto backend = MakeFibBackend(type);
+    if (!backend)
+      throw Error("Unknown FIB backend=" + type);
+    m_routingTable.SetFibBackend(std::move(backend));
+  }
+
+  /* leave out of the FIB the prefixes covered by a route with the same
+   * next hops (see RoutingTable::SetFibAggregation) */
+  void EnableFibAggregation(bool flag) {
+    m_routingTable.SetFibAggregation(flag);
+  }
+
+  /* how DvInfo is signed: "rsa", "ecdsa", "hmac" or "digest" (see SigningMode) */
+  void SetSigningMode(const std::string& mode) {
+    if (!ParseSigningMode(mode, m_signingMode))
+      throw Error("Unknown signing mode=" + mode);
+  }
+
+  /* shared key of the neighborhood, used by the hmac signing mode */
+  void SetHmacKey(const std::string& key) {
+    m_hmacSigner.reset(new HmacSigner(Name(m_network).append("HMAC"), key));
+  }
+
+  void SetMaxVerificationsInFlight(uint32_t x) {
+    m_dvinfoVerifyMaxInFlight = std::max<uint32_t>(x, 1);
+  }
+
+  /* Trickle-like Hellos: the interval doubles up to SetHelloIntervalMax
+   * while the neighborhood is stable, and each Hello goes out at a random
+   * time in the second half of it; otherwise Hellos are periodic */
+  void EnableAdaptiveHello(bool flag) {
+    m_enableAdaptiveHello = flag;
+  }
+
+  /* longest Hello interval (seconds) reached while the neighborhood is stable */
+  void SetHelloIntervalMax(uint32_t x) {
+    m_helloIntervalMax = std::max<int>(x, m_helloIntervalIni);
+  }
+
+  /* Hello suppression: skip a Hello after overhearing k neighbors announce
+   * the same digest in the interval (0 disables) */
+  void SetHelloRedundancy(uint32_t k) {
+    m_helloRedundancy = k;
+  }
+
+  /* number of neighbors announced in each Hello with priority to get DvInfo */
+  void SetHelloPriorityNeighbors(uint32_t x) {
+    m_helloPriorityNeighbors = x;
+  }
+
+  /* link cost from the Hello delivery ratio and the DvInfo RTT (see
+   * LinkMetric) instead of hop count */
+  void EnableLinkMetric(bool flag) {
+    m_enableLinkMetric = flag;
+  }
+
+  /* maximum time a cost change is held before reaching the FIB (0 disables) */
+  void SetMaxSettlingTime(uint32_t ms) {
+    m_maxSettlingTime = time::milliseconds(ms);
+  }
+
+  /* recently removed neighbors cache: size and TTL (seconds) */
+  void SetRemovedNeighborCache(uint32_t size, uint32_t ttl) {
+    m_removedNeighborsMax = size;
+    m_removedNeighborTtl = time::seconds(ttl);
+  }
+
+  void SetDvInfoMaxRetx(uint32_t x) {
+    m_dvinfoMaxRetx = x;
+  }
+
+  uint64_t GetDvInfoRecoveredCount() {
+    return m_dvinfoRecovered;
+  }
+
+  uint64_t GetDvInfoStaleCount() {
+    return m_dvinfoStale;
+  }
+
+  uint64_t GetDvInfoAbandonedCount() {
+    return m_dvinfoAbandoned;
+  }
+
+  uint64_t GetHelloSentCount() {
+    return m_helloSent;
+  }
+
+  uint64_t GetHelloSuppressedCount() {
+    return m_helloSuppressed;
+  }
+
+  uint64_t GetHelloTriggeredCount() {
+    return m_helloTriggered;
+  }
+
+  /* minimum time (milliseconds) between Hellos triggered by routing table
+   * changes (0 disables triggered Hellos) */
+  void SetTriggeredHelloInterval(uint32_t ms) {
+    m_triggeredHelloInterval = time::milliseconds(ms);
+  }
+
   void EnableDSK(bool flag) {
     m_enableDSK = flag;
   }
@@ -134,47 +270,130 @@ public:
   }
 
 private:
-  typedef std::map<std::string, NeighborEntry> NeighborMap;
+  typedef std::map<PrefixId, NeighborEntry> NeighborMap;
+
+  /* reassembly state of a segmented DvInfo being fetched from a neighbor */
+  struct DvInfoFetch {
+    Name prefix;         /* DvInfo name without the segment component */
+    uint64_t finalSeg = 0;
+    uint64_t nextSeg = 1;
+    uint32_t inFlight = 0;
+    std::map<uint64_t, std::string> segments;
+  };
+
+  /* neighbor state kept for a while after the neighbor is removed, so
+   * that it is restored if the neighbor comes back (see RestoreNeighbor) */
+  struct RemovedNeighbor {
+    NeighborEntry entry;
+    time::steady_clock::TimePoint removedAt;
+  };
+
+  /* cost change on hold for the settling time (see SettleRoute) */
+  struct SettlingRoute {
+    RoutingEntry entry;
+    scheduler::EventId event;
+  };
+  /* settling time measurement of a prefix (see SampleSettlingTime) */
+  struct SettlingStats {
+    time::nanoseconds avg;  /* weighted settling time */
+    uint64_t seqNum = 0;    /* seqNum being measured */
+    uint32_t bestCost = 0;
+    time::steady_clock::TimePoint firstArrival;  /* first update of the seqNum */
+    time::steady_clock::TimePoint bestArrival;   /* last cost improvement */
+  };
+
+  /* DvInfo waiting for (or under) signature verification */
+  struct DvInfoVerification {
+    enum State { PENDING, VALID, INVALID };
+    PrefixId neighbor;
+    std::shared_ptr<ndn::Data> data;
+    State state = PENDING;
+  };
+
+  /* signed segments of a DvInfo reply */
+  struct DvInfoReply {
+    uint32_t version;    /* routing table version it was encoded from */
+    Name signer;         /* key it was signed with */
+    std::vector<std::shared_ptr<ndn::Data>> segments;
+    bool expiring = false;
+    bool retired = false;  /* kept, but not served anymore */
+  };
 
   void processInterest(const ndn::Interest& interest);
   void OnHelloInterest(const ndn::Interest& interest, uint64_t inFaceId);
   void OnKeyInterest(const ndn::Interest& interest);
   void OnDvInfoInterest(const ndn::Interest& interest);
   void ReplyDvInfoInterest(const ndn::Interest& interest);
+  void ExpireDvInfoReplies(uint32_t version, const Name& signer);
   void OnDvInfoContent(const ndn::Interest& interest, const ndn::Data& data);
   void OnDvInfoTimedOut(const ndn::Interest& interest, uint32_t retx);
-  void OnDvInfoNack(const ndn::Interest& interest, const ndn::lp::Nack& nack);
+  void OnDvInfoNack(const ndn::Interest& interest, const ndn::lp::Nack& nack, uint32_t retx);
   void SchedDvInfoInterest(NeighborEntry& neighbor, bool wait = false, uint32_t retx = 0);
-  void SendDvInfoInterest(const std::string& neighbor_name, uint32_t retx = 0);
+  void SendDvInfoInterest(PrefixId neighbor, uint32_t retx = 0);
+  void SendDvInfoSegmentInterest(const Name& prefix, uint64_t seg, uint32_t retx = 0);
+  void OnDvInfoSegmentTimedOut(const ndn::Interest& interest, uint32_t retx);
+  void FillDvInfoPipeline(DvInfoFetch& fetch);
   void OnValidatedDvInfo(const ndn::Data& data);
+  void ProcessDvInfo(NeighborEntry& neighbor, const uint8_t* buf, size_t buf_size);
   void OnDvInfoValidationFailed(const ndn::Data& data, const ndn::security::v2::ValidationError& ve);
-  void SendHelloInterest();
+  void StartDvInfoVerifications();
+  void VerifyDvInfo(std::shared_ptr<DvInfoVerification> job);
+  void CommitDvInfoVerifications(PrefixId neighbor);
+  void ReleaseChainWalk(const Name& keyName, bool valid);
+  bool VerifyWithCachedCert(const ndn::Data& data, const std::string& neighPrefix);
+  void CacheNeighborCert(const ndn::security::v2::Certificate& cert);
+  void FetchNeighborCert(const Name& keyName);
+  void OnNeighborCert(const ndn::Data& data);
+  void SendHelloInterest(bool triggered = false);
+  void TriggerHello();
   void registerPrefixes();
   void registerNeighborPrefix(NeighborEntry& neighbor, uint64_t oldFaceId, uint64_t newFaceId);
+  void ReleaseNeighborFace(uint64_t faceId, PrefixId neigh);
   bool isInfinityCost(uint32_t cost);
   bool isValidCost(uint32_t cost);
-  void EncodeDvInfo(std::string& out);
-  void processDvInfoFromNeighbor(NeighborEntry& neighbor, RoutingTable& dvinfo_other);
+  void EncodeDvInfo(std::string& out, uint32_t baseVersion = 0);
+  void processDvInfoFromNeighbor(NeighborEntry& neighbor, const uint8_t* buf, size_t buf_size);
+  bool processDvInfoEntry(NeighborEntry& neighbor, const std::string& uri, uint64_t seq, uint32_t cost);
   uint32_t CalculateCostToNeigh(NeighborEntry&, uint32_t cost);
+  void UpdateLinkCost(NeighborEntry& neighbor);
+  bool SettleRoute(RoutingEntry& re, RoutingEntry& installed);
+  void SampleSettlingTime(PrefixId prefix, uint64_t seqNum, uint32_t cost);
+  time::nanoseconds SettlingDelay(PrefixId prefix);
+  void CommitSettledRoute(PrefixId prefix);
+  void DropSettlingNextHop(PrefixId prefix, uint64_t faceId);
+  void ScheduleHelloInterest();
+  bool SuppressHello();
   void IncreaseHelloInterval();
   void ResetHelloInterval();
   uint64_t ExtractIncomingFace(const ndn::Interest& interest);
   uint64_t ExtractIncomingFace(const ndn::Data& data);
-  void UpdateNeighHelloTimeout(NeighborEntry& neighbor);
+  int MaxHelloGap();
+  void UpdateNeighHelloTimeout(NeighborEntry& neighbor, uint32_t interval);
   void RescheduleNeighRemoval(NeighborEntry& neighbor);
-  void RemoveNeighbor(const std::string neigh);
+  void ScheduleNeighSweep(time::steady_clock::TimePoint when);
+  void SweepNeighbors();
+  void RemoveNeighbor(PrefixId neigh);
+  void RememberNeighbor(NeighborEntry& neighbor);
+  bool RestoreNeighbor(NeighborEntry& neighbor);
+  void ResetSyncedVersions();
   uint64_t CreateUnicastFace(std::string mac);
-  std::string GetNeighborToken();
-  void UpdateRoutingTableDigest();
+  void GetNeighborToken(proto::Hello& hello);
   void ManageSigningInfo();
   void createDSK(std::string subjectName);
   const ndn::security::SigningInfo& getSigningInfo();
+  void SignDvInfo(ndn::Data& data);
 
   void
   buildRouterPrefix()
   {
     m_routerPrefix = m_network;
     m_routerPrefix.append(m_routerName);
+    m_routerPrefixUri = m_routerPrefix.toUri();
+  }
+
+  /* URI of an interned prefix, for logging and wire encoding */
+  const std::string& PrefixUri(PrefixId id) {
+    return m_routingTable.GetPrefixUri(id);
   }
   
   /** @brief check if it is a valid router by extracting the router tag 
@@ -211,34 +430,36 @@ private:
     return name.getSubName(prefix.size(), 3).toUri();
   }
 
-  /** @brief Extracts the number of prefixes annouced by the neighbor
+  /** @brief Extracts the version from a DvInfo Interest (or Data)
    *
-   * @param name: The interest name received from a neighbor. It 
-   * should be formatted:
-   *    <NDVR_HELLO_PREFIX>/<network>/%C1.Router/<router_name>/<num_prefix>/<digest>/<version>(/<params>?)
+   * @param name: The DvInfo name. It should be formatted:
+   *    <NDVR_DVINFO_PREFIX>/<network>/%C1.Router/<router_name>/<version>/<base_version>/<segment>
    */
-  uint32_t ExtractNumPrefixesFromAnnounce(const Name& name) {
-    return name.get(kNdvrHelloPrefix.size()+3).toNumber();
+  uint32_t ExtractVersionFromDvInfo(const Name& name) {
+    return name.get(kNdvrDvInfoPrefix.size()+3).toNumber();
   }
 
-  /** @brief Extracts the digest annouced by the neighbor
+  /** @brief Extracts the base version from a DvInfo Interest (or Data)
    *
-   * @param name: The interest name received from a neighbor. It 
-   * should be formatted:
-   *    <NDVR_HELLO_PREFIXX>/<network>/%C1.Router/<router_name>/<num_prefix>/<digest>/<version>(/<params>?)
+   * @param name: The DvInfo name. It should be formatted:
+   *    <NDVR_DVINFO_PREFIX>/<network>/%C1.Router/<router_name>/<version>/<base_version>/<segment>
+   *
+   * The base version is the version of the last DvInfo the requester has
+   * processed from us (0 means a full snapshot is requested)
    */
-  std::string ExtractDigestFromAnnounce(const Name& name) {
-    return name.get(kNdvrHelloPrefix.size()+3+1).toUri();
+  uint32_t ExtractBaseVersionFromDvInfo(const Name& name) {
+    if (name.size() <= kNdvrDvInfoPrefix.size()+3+1)
+      return 0;
+    return name.get(kNdvrDvInfoPrefix.size()+3+1).toNumber();
   }
 
-  /** @brief Extracts the version annouced by the neighbor
+  /** @brief Checks if the DvInfo Interest (or Data) name carries a segment
    *
-   * @param name: The interest name received from a neighbor. It 
-   * should be formatted:
-   *    <NDVR_HELLO_PREFIXX>/<network>/%C1.Router/<router_name>/<num_prefix>/<digest>/<version>(/<params>?)
+   * @param name: The DvInfo name. It should be formatted:
+   *    <NDVR_DVINFO_PREFIX>/<network>/%C1.Router/<router_name>/<version>/<base_version>/<segment>
    */
-  uint32_t ExtractVersionFromAnnounce(const Name& name) {
-    return name.get(kNdvrHelloPrefix.size()+3+2).toNumber();
+  bool HasSegmentInDvInfo(const Name& name) {
+    return name.size() == kNdvrDvInfoPrefix.size()+3+3 && name.get(-1).isSegment();
   }
 
   time::seconds getSecsSinceLastDSKCert() {
@@ -257,16 +478,35 @@ private:
 
   ndn::KeyChain m_keyChain;
   Name m_routerPrefix;
+  std::string m_routerPrefixUri;
   NeighborMap m_neighMap;
-  std::map<std::string, uint64_t> m_neighToFaceId;
+  std::map<PrefixId, uint64_t> m_neighToFaceId;
+  std::map<PrefixId, RemovedNeighbor> m_removedNeighbors;
+  size_t m_removedNeighborsMax = 32;
+  time::seconds m_removedNeighborTtl = time::seconds(60);
   RoutingTable m_routingTable;
   int m_helloIntervalIni;
   int m_helloIntervalCur;
   int m_helloIntervalMax;
+  bool m_enableAdaptiveHello = false;
+  uint32_t m_helloRedundancy = 0;
+  uint32_t m_helloConsistentHeard = 0;  /* Hellos with our digest heard in the interval */
+  bool m_helloLastSuppressed = false;
+  uint64_t m_helloSent = 0;  /* periodic ones */
+  uint64_t m_helloSuppressed = 0;
+  uint64_t m_helloSeq = 0;  /* every Hello sent, periodic or triggered */
+  uint64_t m_helloTriggered = 0;
   int m_localRTInterval;
   int m_localRTTimeout;
   bool m_enableUnicastFaces = true;
-  std::string m_macaddr;
+  bool m_enableDeltaDvInfo = false;
+  bool m_enableLinkMetric = false;
+  time::milliseconds m_linkRttRef = time::milliseconds(200);  /* about the DvInfo reply delay */
+  double m_linkCostHysteresis = 0.2;
+  time::milliseconds m_maxSettlingTime = time::milliseconds(0);
+  std::unordered_map<PrefixId, SettlingRoute> m_settlingRoutes;
+  std::unordered_map<PrefixId, SettlingStats> m_settlingStats;
+  std::string m_macaddr;  /* 6-byte MAC address announced in our Hellos */
   /* m_slotTime (microseconds)
    * SlotTime is the time to transmit a frame on the physical medium
    * (e.g., 802.3 100Mbps is 51us, 802.11b is 20us, 802.11ac is 9us,
@@ -279,7 +519,7 @@ private:
    * */
   uint32_t m_c = 4;
   /* For DvInfo interest suppression */
-  std::unordered_map<std::string, scheduler::EventId> dvinfointerest_event;
+  std::unordered_map<PrefixId, scheduler::EventId> dvinfointerest_event;
   /* Signing Key separation into long term and short term keys (i.e.,
    * KSK - Key signing key and DSK - Data signing key) */
   bool m_enableDSK = false;
@@ -288,10 +528,56 @@ private:
   ndn::security::SigningInfo m_signingInfoDSK = ndn::security::SigningInfo();
   time::steady_clock::TimePoint m_lastDSKCert = time::steady_clock::TimePoint::max();
   uint64_t m_signedDataAmountDSK = 0;
+  SigningMode m_signingMode = SigningMode::RSA;
+  /* verified certificates of the neighbors (key name -> certificate),
+   * kept until the end of their validity period or m_certCacheMaxTtl */
+  struct VerifiedCert {
+    ndn::security::v2::Certificate cert;
+    time::system_clock::TimePoint expiry;
+  };
+  std::map<Name, VerifiedCert> m_verifiedCerts;
+  time::seconds m_certCacheMaxTtl = time::hours(1);
+  /* DvInfo verification stage: at most m_dvinfoVerifyMaxInFlight
+   * verifications run at a time, the others wait in the backlog; each
+   * neighbor queue keeps the arrival order for the commit */
+  std::map<PrefixId, std::deque<std::shared_ptr<DvInfoVerification>>> m_dvinfoVerifyQueues;
+  std::deque<std::shared_ptr<DvInfoVerification>> m_dvinfoVerifyBacklog;
+  uint32_t m_dvinfoVerifyInFlight = 0;
+  uint32_t m_dvinfoVerifyMaxInFlight = 8;
+  bool m_dvinfoVerifyStarting = false;
+  /* arrivals signed by a key that still has a DvInfo pending are collected
+   * for m_dvinfoVerifyBatchWindow before starting; only one DvInfo per
+   * unknown signing key goes to the validator, the others signed by that
+   * key wait in m_dvinfoChainWalks and are verified against the fetched
+   * certificate */
+  time::milliseconds m_dvinfoVerifyBatchWindow = time::milliseconds(10);
+  scheduler::EventId dvinfoverify_event;
+  std::map<Name, std::vector<std::shared_ptr<DvInfoVerification>>> m_dvinfoChainWalks;
+  std::unique_ptr<HmacSigner> m_hmacSigner;
 
   scheduler::EventId sendhello_event;  /* async send hello event scheduler */
-  scheduler::EventId increasehellointerval_event;  /* increase hello interval event scheduler */
+  scheduler::EventId triggeredhello_event;  /* Hello triggered by a routing table change */
+  time::steady_clock::TimePoint m_lastTriggeredHello;
+  time::milliseconds m_triggeredHelloInterval = time::milliseconds(0);
+  scheduler::EventId neighsweep_event;  /* removal of expired neighbors */
+  time::steady_clock::TimePoint m_neighSweepTime;
   scheduler::EventId replydvinfo_event;  /* group dvinfo replies to avoid duplicate */
+  std::map<Name, Interest> m_pendingDvInfoInterests;  /* distinct DvInfo interests waiting for replydvinfo_event */
+  /* DvInfo segmentation: signed segments of the replies (keyed by DvInfo
+   * name without segment) are reused while the routing table version and
+   * the signing key stay the same; outdated ones are kept for a while, so
+   * that the requester can fetch the remaining segments from the same
+   * encoding */
+  uint32_t m_dvinfoSegmentSize = 1000;  /* bytes of encoded DvInfo per Data */
+  uint32_t m_dvinfoSegmentWindow = 4;   /* segments in flight per fetch */
+  uint32_t m_dvinfoSegmentMaxRetx = 2;
+  uint32_t m_dvinfoMaxRetx = 3;   /* retransmissions of a DvInfo Interest */
+  uint64_t m_dvinfoRecovered = 0; /* fetches completed after a retransmission */
+  uint64_t m_dvinfoStale = 0;     /* retransmissions dropped, newer version announced */
+  uint64_t m_dvinfoAbandoned = 0; /* fetches given up after m_dvinfoMaxRetx */
+  std::map<Name, DvInfoReply> m_dvinfoReplies;
+  time::milliseconds m_dvinfoReplyFreshness = time::milliseconds(1000);
+  std::map<PrefixId, DvInfoFetch> m_dvinfoFetches;  /* neighbor -> ongoing fetch */
   scheduler::EventId managesigninginfo_event;  /* manage signing info (check and update if needed) */
   std::random_device rdevice_;
   std::mt19937 m_rengine;
@@ -300,9 +586,10 @@ private:
   std::poisson_distribution<> m_data_gen_dist = std::poisson_distribution<>(data_generation_rate_mean);
   std::uniform_int_distribution<> packet_dist = std::uniform_int_distribution<>(10000, 15000);   /* microseconds */
 
-  /* m_pivot (int) - iteractor for the circular list of neighbors
-   * which points to the next neighbors with priority to get DvInfo */
-  NeighborMap::iterator m_pivot;
+  /* circular list of neighbors, m_helloPriorityNeighbors of them are
+   * announced in each Hello with priority to get DvInfo */
+  NeighborRing m_neighRing;
+  uint32_t m_helloPriorityNeighbors = 2;
 };
 
 } // namespace ndvr
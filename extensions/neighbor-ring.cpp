@@ -0,0 +1,38 @@
+#include "neighbor-ring.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+void NeighborRing::Insert(PrefixId neigh) {
+  if (m_pos.count(neigh))
+    return;
+  m_pos.emplace(neigh, m_ring.size());
+  m_ring.push_back(neigh);
+}
+
+void NeighborRing::Erase(PrefixId neigh) {
+  auto it = m_pos.find(neigh);
+  if (it == m_pos.end())
+    return;
+
+  size_t pos = it->second;
+  m_pos.erase(it);
+  if (pos != m_ring.size() - 1) {
+    m_ring[pos] = m_ring.back();
+    m_pos[m_ring[pos]] = pos;
+  }
+  m_ring.pop_back();
+}
+
+PrefixId NeighborRing::Next(std::mt19937& rengine) {
+  if (m_step >= m_ring.size()) {
+    /* new round: go to a random position */
+    std::uniform_int_distribution<size_t> rand(0, m_ring.size() - 1);
+    m_start = rand(rengine);
+    m_step = 0;
+  }
+  return m_ring[(m_start + m_step++) % m_ring.size()];
+}
+
+} // namespace ndvr
+} // namespace ndn
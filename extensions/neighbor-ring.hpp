@@ -0,0 +1,54 @@
+#ifndef _NEIGHBORRING_H_
+#define _NEIGHBORRING_H_
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "prefix-table.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+/**
+ * @brief round-robin ring of neighbors
+ *
+ *   Picks the neighbors announced as "priority" in each Hello (the ones
+ *   that should request our DvInfo right away). Each round starts at a
+ *   random position and goes once around the ring, so that all neighbors
+ *   get their turn without every router announcing the same ones.
+ *
+ *   Neighbors are kept in a vector indexed by position, plus a map from
+ *   PrefixId (the stable handle) to position, so next, random start,
+ *   insert and erase are all O(1). Erase moves the last neighbor into the
+ *   freed slot, so the order inside a round is not preserved.
+ */
+class NeighborRing {
+public:
+  void Insert(PrefixId neigh);
+  void Erase(PrefixId neigh);
+  PrefixId Next(std::mt19937& rengine);
+
+  PrefixId operator[](size_t i) const {
+    return m_ring[i];
+  }
+
+  size_t size() const {
+    return m_ring.size();
+  }
+
+  bool empty() const {
+    return m_ring.empty();
+  }
+
+private:
+  std::vector<PrefixId> m_ring;
+  std::unordered_map<PrefixId, size_t> m_pos;
+  size_t m_start = 0;  /* random position where the current round started */
+  size_t m_step = 0;   /* neighbors visited in the current round */
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _NEIGHBORRING_H_
@@ -0,0 +1,26 @@
+#include "prefix-table.hpp"
+
+namespace ndn {
+namespace ndvr {
+
+PrefixId PrefixTable::Intern(const std::string& uri) {
+  auto it = m_ids.find(uri);
+  if (it != m_ids.end())
+    return it->second;
+
+  PrefixId id = m_prefixes.size();
+  m_prefixes.push_back({uri, Name(uri)});
+  m_ids.emplace(uri, id);
+  return id;
+}
+
+bool PrefixTable::Find(const std::string& uri, PrefixId& id) const {
+  auto it = m_ids.find(uri);
+  if (it == m_ids.end())
+    return false;
+  id = it->second;
+  return true;
+}
+
+} // namespace ndvr
+} // namespace ndn
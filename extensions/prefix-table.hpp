@@ -0,0 +1,57 @@
+#ifndef _PREFIXTABLE_H_
+#define _PREFIXTABLE_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ndn-cxx/name.hpp>
+
+namespace ndn {
+namespace ndvr {
+
+typedef uint32_t PrefixId;
+
+/**
+ * @brief interning table of name prefixes
+ *
+ *   Maps each name prefix (in URI format) to a compact integer id, which
+ *   is what the routing table, the neighbor structures and the FIB glue
+ *   use as key. The URI and the parsed Name of each prefix are kept, so
+ *   the conversion only happens once, when the prefix is first seen on
+ *   the wire.
+ *
+ *   Ids are never released: the table grows with the number of distinct
+ *   prefixes seen by the router.
+ */
+class PrefixTable {
+public:
+  PrefixId Intern(const std::string& uri);
+  bool Find(const std::string& uri, PrefixId& id) const;
+
+  const std::string& GetUri(PrefixId id) const {
+    return m_prefixes[id].uri;
+  }
+
+  const Name& GetName(PrefixId id) const {
+    return m_prefixes[id].name;
+  }
+
+  size_t size() const {
+    return m_prefixes.size();
+  }
+
+private:
+  struct Prefix {
+    std::string uri;
+    Name name;
+  };
+
+  std::vector<Prefix> m_prefixes;
+  std::unordered_map<std::string, PrefixId> m_ids;
+};
+
+} // namespace ndvr
+} // namespace ndn
+
+#endif // _PREFIXTABLE_H_
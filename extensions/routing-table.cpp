@@ -1,48 +1,88 @@
-#include <sstream> 
 #include <string>
+#include <set>
+#include <algorithm>
 #include <boost/uuid/sha1.hpp>
 
 #include "routing-table.hpp"
 
-#include <ns3/ndnSIM/helper/ndn-fib-helper.hpp>
-#include <ns3/simulator.h>
-#include <ns3/ptr.h>
-#include <ns3/node.h>
-#include <ns3/node-list.h>
-
 namespace ndn {
 namespace ndvr {
 
-void RoutingTable::registerPrefix(std::string name, uint64_t faceId, uint32_t cost) {
-  using namespace ns3;
-  using namespace ns3::ndn;
+void RoutingTable::registerPrefix(PrefixId n, uint64_t faceId, uint32_t cost) {
+  m_fibQueue.Add(n, faceId, cost);
+  if (m_batchDepth == 0)
+    m_fibQueue.Flush();
+}
+
+void RoutingTable::unregisterPrefix(PrefixId n, uint64_t faceId) {
+  m_fibQueue.Remove(n, faceId);
+  if (m_batchDepth == 0)
+    m_fibQueue.Flush();
+}
+
+void RoutingTable::unregisterFace(uint64_t faceId) {
+  m_fibQueue.RemoveFace(faceId);
+  if (m_batchDepth == 0)
+    m_fibQueue.Flush();
+}
+
+void RoutingTable::BeginBatch() {
+  if (m_batchDepth++ == 0)
+    m_batchChanged = false;
+}
+
+bool RoutingTable::CommitBatch() {
+  if (m_batchDepth == 0 || --m_batchDepth > 0)
+    return false;
+
+  m_fibQueue.Flush();
+
+  if (!m_batchChanged)
+    return false;
+  m_batchChanged = false;
+  IncVersion();
+  return true;
+}
+
+void RoutingTable::MarkChanged(PrefixId n) {
+  m_digestDirty = true;
+  if (m_batchDepth > 0)
+    m_batchChanged = true;
 
-  Name namePrefix = Name(name);
-  Ptr<Node> thisNode = NodeList::GetNode(Simulator::GetContext());
-  FibHelper::AddRoute(thisNode, namePrefix, faceId, cost);
+  m_changeLog.emplace_back(m_version + 1, n);
+  while (m_changeLog.size() > m_changeLogSize) {
+    m_changeLogFloor = std::max(m_changeLogFloor, m_changeLog.front().first);
+    m_changeLog.pop_front();
+  }
 }
 
-void RoutingTable::unregisterPrefix(std::string name, uint64_t faceId) {
-  using namespace ns3;
-  using namespace ns3::ndn;
+bool RoutingTable::GetChangesSince(uint32_t version, std::vector<PrefixId>& changes) {
+  /* the log does not cover that version anymore (or never did) */
+  if (version == 0 || version < m_changeLogFloor || version > m_version)
+    return false;
 
-  Name namePrefix = Name(name);
-  Ptr<Node> thisNode = NodeList::GetNode(Simulator::GetContext());
-  FibHelper::RemoveRoute(thisNode, namePrefix, faceId);
+  std::set<PrefixId> changed;
+  for (auto it = m_changeLog.rbegin(); it != m_changeLog.rend() && it->first > version; ++it) {
+    /* deleted entries are left out, as they would be in a full snapshot */
+    if (m_rt.count(it->second))
+      changed.insert(it->second);
+  }
+  changes.assign(changed.begin(), changed.end());
+  return true;
 }
 
-bool RoutingTable::isDirectRoute(std::string n) {
+bool RoutingTable::isDirectRoute(PrefixId n) {
   auto it = m_rt.find(n);
   if (it == m_rt.end())
     return false;
   return it->second.isDirectRoute();
 }
 
-bool RoutingTable::LookupRoute(std::string n) {
+bool RoutingTable::LookupRoute(PrefixId n) {
   return m_rt.count(n);
 }
 
-bool RoutingTable::LookupRoute(std::string n, RoutingEntry& e) {
+bool RoutingTable::LookupRoute(PrefixId n, RoutingEntry& e) {
   auto it = m_rt.find(n);
   if (it == m_rt.end())
     return false;
@@ -50,45 +90,173 @@ bool RoutingTable::LookupRoute(std::string n, RoutingEntry& e) {
   return true;
 }
 
-void RoutingTable::UpdateRoute(RoutingEntry& e, uint64_t new_nh) {
-  if (e.GetFaceId() != new_nh) {
-    unregisterPrefix(e.GetName(), e.GetFaceId());
+bool RoutingTable::LookupLongestPrefix(const Name& name, RoutingEntry& e) {
+  PrefixId key;
+  if (!m_nameTree.FindLongestPrefix(name, key))
+    return false;
+  return LookupRoute(key, e);
+}
+
+void RoutingTable::ListRoutesUnder(const Name& prefix, std::vector<RoutingEntry>& entries) {
+  std::vector<PrefixId> keys;
+  m_nameTree.ListSubtree(prefix, keys);
+  for (const auto& key : keys) {
+    auto it = m_rt.find(key);
+    if (it != m_rt.end())
+      entries.push_back(it->second);
+  }
+}
+
+void RoutingTable::UpdateRoute(RoutingEntry& e) {
+  /* sync the FIB with the next hop set of e */
+  auto it = m_rt.find(e.GetPrefixId());
+  if (it != m_rt.end()) {
+    for (const auto& nh : it->second.GetNextHops()) {
+      if (!e.isNextHop(nh.first))
+        unregisterPrefix(e.GetPrefixId(), nh.first);
+    }
+  }
+  /* the remaining next hops are synced by insert() */
+  if (m_fibAggregation) {
+    insert(e);
+    return;
+  }
+  for (const auto& nh : e.GetNextHops()) {
+    if (it != m_rt.end()) {
+      auto old = it->second.GetNextHops().find(nh.first);
+      if (old != it->second.GetNextHops().end() && old->second.cost == nh.second.cost)
+        continue;
+    }
+    registerPrefix(e.GetPrefixId(), nh.first, nh.second.cost);
   }
-  e.SetFaceId(new_nh);
-  AddRoute(e);
+  insert(e);
 }
 
 void RoutingTable::AddRoute(RoutingEntry& e) {
-  registerPrefix(e.GetName(), e.GetFaceId(), e.GetCost());
-  m_rt[e.GetName()] = e;
-  UpdateDigest();
+  UpdateRoute(e);
 }
 
-void RoutingTable::DeleteRoute(RoutingEntry& e, uint64_t nh) {
-  // TODO: we may have other faces to this name prefix (multipath).
-  // In that case, we should only remove the nexthop
-  unregisterPrefix(e.GetName(), nh);
-  m_rt.erase(e.GetName());
-  UpdateDigest();
+bool RoutingTable::DeleteRoute(RoutingEntry& e, uint64_t nh) {
+  /* other next hops left: fail over to the best of them */
+  if (e.RemoveNextHop(nh)) {
+    unregisterPrefix(e.GetPrefixId(), nh);
+    insert(e);
+    return true;
+  }
+  unregisterPrefix(e.GetPrefixId(), nh);
+  erase(e.GetPrefixId());
+  return false;
+}
+
+static bool
+SameNextHops(const RoutingEntry& a, const RoutingEntry& b) {
+  const auto& x = a.GetNextHops();
+  const auto& y = b.GetNextHops();
+  return x.size() == y.size() &&
+         std::equal(x.begin(), x.end(), y.begin(), [] (const RoutingEntry::NextHopMap::value_type& p,
+                                                      const RoutingEntry::NextHopMap::value_type& q) {
+           return p.first == q.first && p.second.cost == q.second.cost;
+         });
 }
 
 void RoutingTable::insert(RoutingEntry& e) {
-  m_rt[e.GetName()] = e;
-  UpdateDigest();
+  auto it = m_rt.find(e.GetPrefixId());
+  bool changed = true;
+  bool nextHopsChanged = true;
+  if (it != m_rt.end()) {
+    /* changes on alternative next hops are not advertised */
+    changed = it->second.GetSeqNum() != e.GetSeqNum() || it->second.GetCost() != e.GetCost();
+    nextHopsChanged = !SameNextHops(it->second, e);
+    XorEntryDigest(it->first, it->second.GetSeqNum());
+    it->second = e;
+  } else {
+    m_rt.emplace(e.GetPrefixId(), e);
+    m_nameTree.Insert(m_prefixes.GetName(e.GetPrefixId()), e.GetPrefixId());
+  }
+  XorEntryDigest(e.GetPrefixId(), e.GetSeqNum());
+  if (changed)
+    MarkChanged(e.GetPrefixId());
+
+  /* the prefixes under this one may be covered by it now, or not anymore */
+  if (m_fibAggregation && nextHopsChanged) {
+    SyncFib(e);
+    SyncFibUnder(m_prefixes.GetName(e.GetPrefixId()));
+  }
+}
+
+void RoutingTable::erase(PrefixId n) {
+  auto it = m_rt.find(n);
+  if (it == m_rt.end())
+    return;
+  XorEntryDigest(it->first, it->second.GetSeqNum());
+  m_nameTree.Erase(m_prefixes.GetName(n));
+  m_rt.erase(it);
+  MarkChanged(n);
+
+  if (m_fibAggregation)
+    SyncFibUnder(m_prefixes.GetName(n));
 }
 
-void RoutingTable::UpdateDigest() {
-  std::stringstream rt_str, out;
+bool RoutingTable::IsAggregated(RoutingEntry& e) {
+  const Name& name = m_prefixes.GetName(e.GetPrefixId());
+  if (e.GetNextHops().empty() || name.empty())
+    return false;
+  RoutingEntry cover;
+  if (!LookupLongestPrefix(name.getPrefix(-1), cover))
+    return false;
+  return SameNextHops(cover, e);
+}
+
+void RoutingTable::SyncFib(RoutingEntry& e) {
+  /* the FIB queue skips the operations that do not change anything */
+  bool aggregated = IsAggregated(e);
+  for (const auto& nh : e.GetNextHops()) {
+    if (aggregated)
+      unregisterPrefix(e.GetPrefixId(), nh.first);
+    else
+      registerPrefix(e.GetPrefixId(), nh.first, nh.second.cost);
+  }
+}
+
+void RoutingTable::SyncFibUnder(const Name& prefix) {
+  std::vector<RoutingEntry> entries;
+  ListRoutesUnder(prefix, entries);
+  for (auto& entry : entries) {
+    if (m_prefixes.GetName(entry.GetPrefixId()) != prefix)
+      SyncFib(entry);
+  }
+}
+
+void RoutingTable::IncSeqNum(PrefixId n, uint64_t i) {
+  auto it = m_rt.find(n);
+  if (it == m_rt.end())
+    return;
+  XorEntryDigest(it->first, it->second.GetSeqNum());
+  it->second.IncSeqNum(i);
+  XorEntryDigest(it->first, it->second.GetSeqNum());
+  MarkChanged(n);
+}
+
+void RoutingTable::XorEntryDigest(PrefixId n, uint64_t seqNum) {
+  /* XOR is its own inverse: the same call adds or removes the entry */
+  std::string entry_str = m_prefixes.GetUri(n) + std::to_string(seqNum);
   boost::uuids::detail::sha1 sha1;
   unsigned int hash[5];
-  for (auto it = m_rt.begin(); it != m_rt.end(); ++it)
-    rt_str << it->first << it->second.GetSeqNum();
-  sha1.process_bytes(rt_str.str().c_str(), rt_str.str().size());
+  sha1.process_bytes(entry_str.c_str(), entry_str.size());
   sha1.get_digest(hash);
-  for(std::size_t i=0; i<sizeof(hash)/sizeof(hash[0]); ++i) {
-      out << std::hex << hash[i];
+  for (std::size_t i = 0; i < m_digestAcc.size(); ++i)
+    m_digestAcc[i] ^= hash[i];
+}
+
+void RoutingTable::UpdateDigest() const {
+  m_digestDirty = false;
+  m_digest.clear();
+  if (m_rt.empty())
+    return;
+  for (std::size_t i = 0; i < m_digestAcc.size(); ++i) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+      m_digest.push_back(static_cast<char>((m_digestAcc[i] >> shift) & 0xFF));
   }
-  m_digest = out.str();
 }
 
 } // namespace ndvr
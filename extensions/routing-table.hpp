@@ -2,27 +2,45 @@
 #define _ROUTINGTABLE_H_
 
 #include <map>
+#include <array>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "fib-queue.hpp"
+#include "name-tree.hpp"
+#include "prefix-table.hpp"
 
 
 namespace ndn {
 namespace ndvr {
 
+/* per-face cost and sequence number of a next hop of a RoutingEntry */
+struct NextHop {
+  uint32_t cost;
+  uint64_t seqNum;
+};
+
 class RoutingEntry {
 public:
+  typedef std::map<uint64_t, NextHop> NextHopMap;
+
   RoutingEntry()
   {
   }
 
-  RoutingEntry(std::string name, uint64_t seqNum, uint32_t cost, uint64_t faceId)
-    : m_name(name)
+  RoutingEntry(PrefixId prefixId, uint64_t seqNum, uint32_t cost, uint64_t faceId)
+    : m_prefixId(prefixId)
     , m_seqNum(seqNum)
     , m_cost(cost)
     , m_faceId(faceId)
   {
+    if (faceId != 0)
+      m_nextHops[faceId] = {cost, seqNum};
   }
 
-  RoutingEntry(std::string name, uint64_t seqNum, uint32_t cost)
-    : RoutingEntry(name, seqNum, cost, 0)
+  RoutingEntry(PrefixId prefixId, uint64_t seqNum, uint32_t cost)
+    : RoutingEntry(prefixId, seqNum, cost, 0)
   {
   }
 
@@ -30,12 +48,12 @@ public:
   {
   }
 
-  void SetName(std::string name) {
-    m_name = name;
+  void SetPrefixId(PrefixId prefixId) {
+    m_prefixId = prefixId;
   }
 
-  std::string GetName() const {
-    return m_name;
+  PrefixId GetPrefixId() const {
+    return m_prefixId;
   }
 
   void SetSeqNum(uint64_t seqNum) {
@@ -55,8 +73,11 @@ public:
   }
 
   void SetCost(uint64_t faceId, uint32_t cost) {
-    // TODO: set cost only for this faceId
-    m_cost = cost;
+    auto it = m_nextHops.find(faceId);
+    if (it == m_nextHops.end())
+      return;
+    it->second.cost = cost;
+    SelectBestNextHop();
   }
 
   uint32_t GetCost() {
@@ -71,20 +92,63 @@ public:
     return m_faceId;
   }
 
-  bool isNextHop(uint64_t faceId) {
-    // TODO: in case of multipath, we may need to compare with a list of faces
-    return faceId == m_faceId;
+  bool isNextHop(uint64_t faceId) const {
+    return m_nextHops.count(faceId);
   }
 
   bool isDirectRoute() {
     return m_faceId == 0;
   }
 
+  /* Multipath: every next hop is installed in the FIB with its own cost,
+   * while GetFaceId()/GetCost() report the best one (the advertised cost) */
+  const NextHopMap& GetNextHops() const {
+    return m_nextHops;
+  }
+
+  void SetNextHop(uint64_t faceId, uint32_t cost, uint64_t seqNum) {
+    m_nextHops[faceId] = {cost, seqNum};
+    SelectBestNextHop();
+  }
+
+  /* returns true if there are still other next hops left */
+  bool RemoveNextHop(uint64_t faceId) {
+    m_nextHops.erase(faceId);
+    SelectBestNextHop();
+    return !m_nextHops.empty();
+  }
+
+  /* drop next hops which were learned with an older seqNum */
+  void RemoveStaleNextHops() {
+    for (auto it = m_nextHops.begin(); it != m_nextHops.end(); ) {
+      if (it->second.seqNum < m_seqNum)
+        it = m_nextHops.erase(it);
+      else
+        ++it;
+    }
+    SelectBestNextHop();
+  }
+
 private:
-  std::string m_name;
+  void SelectBestNextHop() {
+    if (m_nextHops.empty())
+      return;
+    /* keep the current next hop on ties, to avoid flapping */
+    auto best = m_nextHops.find(m_faceId);
+    for (auto it = m_nextHops.begin(); it != m_nextHops.end(); ++it) {
+      if (best == m_nextHops.end() || it->second.cost < best->second.cost)
+        best = it;
+    }
+    m_faceId = best->first;
+    m_cost = best->second.cost;
+  }
+
+private:
+  PrefixId m_prefixId;
   uint64_t m_seqNum;
   uint32_t m_cost;
   uint64_t m_faceId;
+  NextHopMap m_nextHops;
 };
 
 /**
@@ -100,28 +164,100 @@ private:
 //class RoutingTable : public std::map<std::string, RoutingEntry> {
 class RoutingTable {
 public:
-  /* The fact that the elements in a map are always sorted by its key 
-   * is important for us for the digest calculation */
-  std::map<std::string, RoutingEntry> m_rt;
+  std::map<PrefixId, RoutingEntry> m_rt;
+
+  /** @brief Groups several mutations of the routing table
+   *
+   *   While a Batch is alive, changes on the routing table do not bump
+   *   the version nor touch the FIB. On Commit() (or when the Batch goes
+   *   out of scope) the FIB queue is flushed and the version is
+   *   incremented once, if anything has changed.
+   *
+   * Example:
+   *    RoutingTable::Batch batch(m_routingTable);
+   *    m_routingTable.AddRoute(e1);
+   *    m_routingTable.DeleteRoute(e2, faceId);
+   *    batch.Commit();
+   */
+  class Batch {
+  public:
+    explicit Batch(RoutingTable& rt)
+      : m_rt(rt)
+      , m_committed(false)
+    {
+      m_rt.BeginBatch();
+    }
+
+    ~Batch()
+    {
+      Commit();
+    }
+
+    /* returns true if the routing table has changed during the batch */
+    bool Commit() {
+      if (m_committed)
+        return false;
+      m_committed = true;
+      return m_rt.CommitBatch();
+    }
+
+  private:
+    RoutingTable& m_rt;
+    bool m_committed;
+  };
 
   RoutingTable()
-    : m_version(1)
-    , m_digest("0")
+    : m_fibQueue(m_prefixes)
+    , m_version(1)
+    , m_digest()
   {
+    m_digestAcc.fill(0);
   }
 
   ~RoutingTable() {}
 
-  void UpdateRoute(RoutingEntry& e, uint64_t new_nh);
+  void UpdateRoute(RoutingEntry& e);
   void AddRoute(RoutingEntry& e);
-  void DeleteRoute(RoutingEntry& e, uint64_t nh);
-  bool isDirectRoute(std::string n);
-  bool LookupRoute(std::string n);
-  bool LookupRoute(std::string n, RoutingEntry& e);
+  bool DeleteRoute(RoutingEntry& e, uint64_t nh);
+  bool isDirectRoute(PrefixId n);
+  bool LookupRoute(PrefixId n);
+  bool LookupRoute(PrefixId n, RoutingEntry& e);
+  bool LookupLongestPrefix(const Name& name, RoutingEntry& e);
+  void ListRoutesUnder(const Name& prefix, std::vector<RoutingEntry>& entries);
   void insert(RoutingEntry& e);
-  void UpdateDigest();
-  void unregisterPrefix(std::string name, uint64_t faceId);
-  void registerPrefix(std::string name, uint64_t faceId, uint32_t cost);
+  void IncSeqNum(PrefixId n, uint64_t i);
+  void unregisterPrefix(PrefixId n, uint64_t faceId);
+  void registerPrefix(PrefixId n, uint64_t faceId, uint32_t cost);
+  void unregisterFace(uint64_t faceId);
+  void BeginBatch();
+  bool CommitBatch();
+  bool GetChangesSince(uint32_t version, std::vector<PrefixId>& changes);
+
+  void SetChangeLogSize(size_t n) {
+    m_changeLogSize = n;
+  }
+
+  void SetFibBackend(std::unique_ptr<FibBackend> backend) {
+    m_fibQueue.SetBackend(std::move(backend));
+  }
+
+  /* FIB aggregation: a prefix with the same next hops (and costs) as its
+   * closest covering prefix in the table gets no FIB entry of its own, the
+   * forwarder's longest prefix match finds the covering one */
+  void SetFibAggregation(bool flag) {
+    m_fibAggregation = flag;
+  }
+
+  /* prefix interning table of this router (see PrefixTable) */
+  PrefixTable& GetPrefixTable() {
+    return m_prefixes;
+  }
+  PrefixId InternPrefix(const std::string& uri) {
+    return m_prefixes.Intern(uri);
+  }
+  const std::string& GetPrefixUri(PrefixId n) const {
+    return m_prefixes.GetUri(n);
+  }
 
   uint32_t GetVersion() {
     return m_version;
@@ -131,11 +267,10 @@ public:
   }
 
   std::string GetDigest() const {
+    if (m_digestDirty)
+      UpdateDigest();
     return m_digest;
   }
-  void SetDigest(std::string s) {
-    m_digest = s;
-  }
 
   // just forward some methods
   decltype(m_rt.begin()) begin() { return m_rt.begin(); }
@@ -143,8 +278,40 @@ public:
   decltype(m_rt.size()) size() { return m_rt.size(); }
 
 private:
+  void erase(PrefixId n);
+  void XorEntryDigest(PrefixId n, uint64_t seqNum);
+  void UpdateDigest() const;
+  void MarkChanged(PrefixId n);
+  bool IsAggregated(RoutingEntry& e);
+  void SyncFib(RoutingEntry& e);
+  void SyncFibUnder(const Name& prefix);
+
+private:
+  PrefixTable m_prefixes;
+  /* FIB operations are queued here and flushed when no batch is open */
+  FibQueue m_fibQueue;
   uint32_t m_version;
-  std::string m_digest;
+  /* The digest (20 bytes, big-endian words of m_digestAcc; empty for an
+   * empty table) is rendered lazily (see GetDigest) */
+  mutable std::string m_digest;
+  mutable bool m_digestDirty = false;
+  /* The digest is the XOR of SHA-1(prefix + seqNum) of every entry, so
+   * it does not depend on the entries order and each insert/erase only
+   * needs to hash the affected entry */
+  std::array<uint32_t, 5> m_digestAcc;
+  /* component-wise index of m_rt keys for prefix queries */
+  NameTree m_nameTree;
+  bool m_fibAggregation = false;
+  /* batch update state (see RoutingTable::Batch) */
+  uint32_t m_batchDepth = 0;
+  bool m_batchChanged = false;
+  /* change log: (version, prefix) of the last m_changeLogSize changes,
+   * used to build delta DvInfo replies. Changes are tagged with the
+   * version they will be advertised with (i.e., m_version+1). Changes
+   * tagged up to m_changeLogFloor were dropped from the log */
+  std::deque<std::pair<uint32_t, PrefixId>> m_changeLog;
+  size_t m_changeLogSize = 1024;
+  uint32_t m_changeLogFloor = 0;
 };
 
 } // namespace ndvr
@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+// ndvr-signing-bench.cpp
+//
+#include "ndvr-app.hpp"
+#include "ndvr-security-helper.hpp"
+#include "ndvr-signing.hpp"
+
+#include <chrono>
+#include <ndn-cxx/security/verification-helpers.hpp>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/ndnSIM-module.h"
+
+namespace ns3 {
+
+/**
+ * Benchmark of the DvInfo signing modes (rsa, ecdsa, hmac and digest).
+ *
+ * First, sign and validate a number of DvInfo-sized Data packets with each
+ * mode and report the throughput (wall clock). Then, run NDVR on a NxN grid
+ * with the chosen signing mode and report the convergence time, ie, the
+ * time when every router has a FIB entry for the prefix of every other
+ * router.
+ *
+ *     ./waf --run="ndvr-signing-bench --signingMode=ecdsa --numNodes=5"
+ */
+NS_OBJECT_ENSURE_REGISTERED(NdvrApp);
+
+static const std::string kHmacKey = "ndvr-bench-shared-key";
+
+void
+BenchSigning(const std::string& modeStr, uint32_t rounds, size_t payloadSize)
+{
+  ::ndn::ndvr::SigningMode mode;
+  if (!::ndn::ndvr::ParseSigningMode(modeStr, mode))
+    return;
+
+  ::ndn::KeyChain keyChain;
+  ::ndn::Name identityName("/bench/" + modeStr);
+  ::ndn::security::Identity identity;
+  if (mode == ::ndn::ndvr::SigningMode::RSA || mode == ::ndn::ndvr::SigningMode::ECDSA)
+    identity = keyChain.createIdentity(identityName, *::ndn::ndvr::MakeKeyParams(mode));
+  ::ndn::ndvr::HmacSigner hmac(::ndn::Name(identityName).append("HMAC"), kHmacKey);
+
+  std::vector<uint8_t> payload(payloadSize, 0xAA);
+  std::vector<std::shared_ptr<::ndn::Data>> packets;
+  for (uint32_t i = 0; i < rounds; i++) {
+    auto data = std::make_shared<::ndn::Data>(::ndn::Name("/localhop/ndvr/dvinfo/bench").appendSegment(i));
+    data->setContent(payload.data(), payload.size());
+    packets.push_back(data);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto& data : packets) {
+    switch (mode) {
+    case ::ndn::ndvr::SigningMode::HMAC:
+      hmac.Sign(*data);
+      break;
+    case ::ndn::ndvr::SigningMode::DIGEST:
+      keyChain.sign(*data, ::ndn::security::signingWithSha256());
+      break;
+    default:
+      keyChain.sign(*data, ::ndn::security::signingByIdentity(identity));
+    }
+  }
+  auto signEnd = std::chrono::steady_clock::now();
+
+  uint32_t valid = 0;
+  for (auto& data : packets) {
+    switch (mode) {
+    case ::ndn::ndvr::SigningMode::HMAC:
+      valid += hmac.Verify(*data);
+      break;
+    case ::ndn::ndvr::SigningMode::DIGEST:
+      valid += ::ndn::security::verifyDigest(*data, ::ndn::DigestAlgorithm::SHA256);
+      break;
+    default:
+      valid += ::ndn::security::verifySignature(*data, identity.getDefaultKey());
+    }
+  }
+  auto verifyEnd = std::chrono::steady_clock::now();
+
+  double signSecs = std::chrono::duration<double>(signEnd - start).count();
+  double verifySecs = std::chrono::duration<double>(verifyEnd - signEnd).count();
+  std::cout << "signing-bench mode=" << modeStr << " rounds=" << rounds << " payload=" << payloadSize
+            << " sign/s=" << rounds / signSecs << " verify/s=" << rounds / verifySecs
+            << " valid=" << valid << std::endl;
+}
+
+void
+CheckConvergence(NodeContainer nodes, std::vector<ndn::Name> prefixes)
+{
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    auto& fib = nodes.Get(i)->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+    for (uint32_t j = 0; j < prefixes.size(); j++) {
+      if (i != j && fib.findExactMatch(prefixes[j]) == nullptr) {
+        Simulator::Schedule(MilliSeconds(100), &CheckConvergence, nodes, prefixes);
+        return;
+      }
+    }
+  }
+  std::cout << "convergence-time=" << Simulator::Now().GetSeconds() << "s" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+  int numNodes = 3;
+  uint32_t rounds = 1000;
+  uint32_t payloadSize = 1000;
+  std::string signingMode = "rsa";
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("1ms"));
+
+  CommandLine cmd;
+  cmd.AddValue("numNodes", "Grid size (numNodes x numNodes)", numNodes);
+  cmd.AddValue("rounds", "Number of Data packets signed/validated per mode", rounds);
+  cmd.AddValue("payloadSize", "Content size of each signed Data packet", payloadSize);
+  cmd.AddValue("signingMode", "Signing mode of the convergence run: rsa, ecdsa, hmac or digest", signingMode);
+  cmd.Parse(argc, argv);
+
+  // 1. Signing/validation throughput of each mode
+  for (const std::string mode : {"rsa", "ecdsa", "hmac", "digest"})
+    BenchSigning(mode, rounds, payloadSize);
+
+  // 2. Convergence time with the chosen mode
+  PointToPointHelper p2p;
+  PointToPointGridHelper grid(numNodes, numNodes, p2p);
+  grid.BoundingBox(100, 100, 400, 400);
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+  ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/multicast");
+
+  std::string network = "/ndn";
+  ::ndn::ndvr::setupRootCert(ndn::Name(network), "config/trust.cert");
+
+  NodeContainer nodes;
+  std::vector<ndn::Name> prefixes;
+  uint64_t idx = 0;
+  for (int i=0; i < numNodes; i++) {
+    for (int j=0; j < numNodes; j++) {
+      Ptr<Node> node = grid.GetNode(i, j);
+      std::string routerName = "/\%C1.Router/Router"+std::to_string(idx);
+      ndn::Name prefix("/ndn/bench");
+      prefix.appendNumber(idx);
+
+      ndn::AppHelper appHelper("NdvrApp");
+      appHelper.SetAttribute("Network", StringValue(network));
+      appHelper.SetAttribute("RouterName", StringValue(routerName));
+      appHelper.SetAttribute("SigningMode", StringValue(signingMode));
+      appHelper.SetAttribute("HmacKey", StringValue(kHmacKey));
+      appHelper.Install(node);
+
+      auto app = DynamicCast<NdvrApp>(node->GetApplication(0));
+      app->AddSigningInfo(::ndn::ndvr::setupSigningInfo(ndn::Name(network + routerName), ndn::Name(network)));
+      app->AddNamePrefix(prefix.toUri());
+
+      nodes.Add(node);
+      prefixes.push_back(prefix);
+      idx += 1;
+    }
+  }
+
+  Simulator::Schedule(MilliSeconds(100), &CheckConvergence, nodes, prefixes);
+  Simulator::Stop(Seconds(100.0));
+
+  Simulator::Run();
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}